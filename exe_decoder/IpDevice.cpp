@@ -63,11 +63,12 @@ AL_TAllocator* createDmaAllocator(const char* deviceName)
 
 extern "C"
 {
+#include "lib_decode/DecChannelMcu.h"
 #include "lib_common/HardwareDriver.h"
-AL_TIDecChannel* AL_DecChannelMcu_Create(AL_TDriver*);
+#include "lib_common/EventReactor.h"
 }
 
-static unique_ptr<CIpDevice> createMcuIpDevice()
+static unique_ptr<CIpDevice> createMcuIpDevice(bool bUseReactor)
 {
   auto device = make_unique<CIpDevice>();
 
@@ -76,7 +77,15 @@ static unique_ptr<CIpDevice> createMcuIpDevice()
   if(!device->m_pAllocator)
     throw runtime_error("Can't open DMA allocator");
 
-  device->m_pDecChannel = AL_DecChannelMcu_Create(AL_GetHardwareDriver());
+  if(bUseReactor)
+  {
+    device->m_pReactor.reset(AL_EventReactor_Create(1), &AL_EventReactor_Destroy);
+
+    if(!device->m_pReactor)
+      throw runtime_error("Can't create event reactor");
+  }
+
+  device->m_pDecChannel = AL_DecChannelMcu_CreateWithReactor(AL_GetHardwareDriver(), device->m_pReactor.get());
 
   if(!device->m_pDecChannel)
     throw runtime_error("Failed to create MCU scheduler");
@@ -92,7 +101,10 @@ shared_ptr<CIpDevice> CreateIpDevice(int* iUseBoard, int iSchedulerType, functio
 
 
   if(iSchedulerType == SCHEDULER_TYPE_MCU)
-    return createMcuIpDevice();
+    return createMcuIpDevice(false);
+
+  if(iSchedulerType == SCHEDULER_TYPE_MCU_REACTOR)
+    return createMcuIpDevice(true);
 
   throw runtime_error("No support for this scheduling type");
 }
@@ -46,12 +46,14 @@ typedef struct AL_t_Allocator AL_TAllocator;
 typedef struct AL_t_IDecChannel AL_TIDecChannel;
 typedef struct AL_t_IpCtrl AL_TIpCtrl;
 typedef struct AL_t_Timer AL_Timer;
+typedef struct AL_t_EventReactor AL_TEventReactor;
 
 /*****************************************************************************/
 struct CIpDevice
 {
   AL_TIDecChannel* m_pDecChannel = nullptr;
   std::shared_ptr<AL_TAllocator> m_pAllocator;
+  std::shared_ptr<AL_TEventReactor> m_pReactor;
   AL_Timer* m_pTimer;
 };
 
@@ -379,6 +379,7 @@ static Config ParseCommandLine(int argc, char* argv[])
   opt.addInt("-loop", &Config.iLoop, "Number of Decoding loop (optional)");
 
   opt.addString("--log", &Config.logsFile, "A file where logged events will be dumped");
+  opt.addFlag("--reactor", &Config.iSchedulerType, "Dispatch the channel statuses from an event reactor instead of a thread per channel", SCHEDULER_TYPE_MCU_REACTOR);
 
 
   string preAllocArgs = "";
@@ -713,7 +714,7 @@ UncompressedOutputWriter::UncompressedOutputWriter(const string& sYuvFileName, c
   AL_TOffsetYC tOffsetYC {};
   AL_TDimension tDimension {};
   AL_TMetaData* Meta = (AL_TMetaData*)AL_SrcMetaData_Create(tDimension, tPitches, tOffsetYC, 0);
-  YuvBuffer = AL_Buffer_Create_And_Allocate(AL_GetDefaultAllocator(), 100, NULL);
+  YuvBuffer = AL_Buffer_Create_And_Allocate(AL_GetHugePageAllocator(), 100, NULL);
 
   if(!YuvBuffer)
     throw runtime_error("Couldn't allocate YuvBuffer");
@@ -1185,7 +1186,7 @@ void SafeMain(int argc, char** argv)
     BufPoolConfig.pMetaData = nullptr;
     BufPoolConfig.debugName = "stream";
 
-    auto ret = bufPool.Init(AL_GetDefaultAllocator(), BufPoolConfig);
+    auto ret = bufPool.Init(AL_GetHugePageAllocator(), BufPoolConfig);
 
     if(!ret)
       throw runtime_error("Can't create BufPool");
@@ -527,15 +527,49 @@ void WriteOneSection(std::ofstream& File, AL_TBuffer* pStream, int iSection, con
 int WriteStream(std::ofstream& HEVCFile, AL_TBuffer* pStream, const AL_TEncChanParam* pChannelParam)
 {
   AL_TStreamMetaData* pStreamMeta = (AL_TStreamMetaData*)AL_Buffer_GetMetaData(pStream, AL_META_TYPE_STREAM);
+  AL_TStreamSection const* pSections = pStreamMeta->pSections;
+  char* pData = (char*)AL_Buffer_GetData(pStream);
   int iNumFrame = 0;
 
+  // sections that follow each other in the buffer are gathered in a single write
+  uint32_t uRunOffset = 0;
+  uint32_t uRunLength = 0;
+
   for(int curSection = 0; curSection < pStreamMeta->uNumSection; ++curSection)
   {
-    if(pStreamMeta->pSections[curSection].uFlags & SECTION_END_FRAME_FLAG)
+    AL_TStreamSection const* pCurSection = &pSections[curSection];
+
+    if(pCurSection->uFlags & SECTION_END_FRAME_FLAG)
       ++iNumFrame;
-    WriteOneSection(HEVCFile, pStream, curSection, pChannelParam);
+
+    if(!pCurSection->uLength)
+      continue;
+
+    bool bWraps = pStream->zSize - pCurSection->uOffset < pCurSection->uLength;
+
+    if(uRunLength && !bWraps && pCurSection->uOffset == uRunOffset + uRunLength)
+    {
+      uRunLength += pCurSection->uLength;
+      continue;
+    }
+
+    if(uRunLength)
+      HEVCFile.write(pData + uRunOffset, uRunLength);
+    uRunLength = 0;
+
+    if(bWraps)
+    {
+      WriteOneSection(HEVCFile, pStream, curSection, pChannelParam);
+      continue;
+    }
+
+    uRunOffset = pCurSection->uOffset;
+    uRunLength = pCurSection->uLength;
   }
 
+  if(uRunLength)
+    HEVCFile.write(pData + uRunOffset, uRunLength);
+
   return iNumFrame;
 }
 
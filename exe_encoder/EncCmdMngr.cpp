@@ -36,6 +36,7 @@
 ******************************************************************************/
 
 #include "EncCmdMngr.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -43,7 +44,7 @@ using namespace std;
 class CCmdTokenizer
 {
 public:
-  CCmdTokenizer(string& sLine)
+  CCmdTokenizer(string const& sLine)
     : m_sLine(sLine),
     m_zBeg(0),
     m_zEnd(0),
@@ -106,80 +107,102 @@ private:
  * Class CEncCmdMngr                                                         *
  *****************************************************************************/
 CEncCmdMngr::CEncCmdMngr(istream& CmdInput, int iLookAhead, int iFreqLT)
-  : m_CmdInput(CmdInput),
-  m_iLookAhead(iLookAhead),
+  : m_iLookAhead(iLookAhead),
   m_iFreqLT(iFreqLT),
-  m_bHasLT(false)
+  m_bHasLT(false),
+  m_zOnTimeCursor(0),
+  m_zLookAheadCursor(0)
 {
-  Refill(0);
+  Compile(CmdInput);
 }
 
 /****************************************************************************/
-void CEncCmdMngr::Refill(int iCurFrame)
+void CEncCmdMngr::Compile(istream& CmdInput)
 {
-  while(m_Cmds.size() && m_Cmds.front().iFrame < iCurFrame)
-    m_Cmds.pop_front();
+  string sLine;
 
-  while((int)m_Cmds.size() < m_iLookAhead && (m_Cmds.empty() || m_Cmds.back().iFrame < iCurFrame + m_iLookAhead))
+  while(getline(CmdInput, sLine))
   {
     TFrmCmd Cmd {};
 
-    if(!ReadNextCmd(Cmd))
-      break;
+    if(ParseCmd(sLine, Cmd, false))
+      m_Cmds.push_back(Cmd);
+  }
+
+  stable_sort(m_Cmds.begin(), m_Cmds.end(), [](TFrmCmd const& a, TFrmCmd const& b) { return a.iFrame < b.iFrame; });
+
+  // all the lines of a frame make a single command
+  size_t zNumCmds = 0;
 
-    m_Cmds.push_back(Cmd);
+  for(size_t i = 0; i < m_Cmds.size(); ++i)
+  {
+    if(zNumCmds && m_Cmds[zNumCmds - 1].iFrame == m_Cmds[i].iFrame)
+      Merge(m_Cmds[zNumCmds - 1], m_Cmds[i]);
+    else
+      m_Cmds[zNumCmds++] = m_Cmds[i];
   }
+
+  m_Cmds.resize(zNumCmds);
 }
 
 /****************************************************************************/
-bool CEncCmdMngr::ReadNextCmd(TFrmCmd& Cmd)
+void CEncCmdMngr::Merge(TFrmCmd& Cmd, TFrmCmd const& Next)
 {
-  std::string sLine;
-  bool bRet = false;
+  Cmd.bSceneChange |= Next.bSceneChange;
+  Cmd.bIsLongTerm |= Next.bIsLongTerm;
+  Cmd.bUseLongTerm |= Next.bUseLongTerm;
+  Cmd.bKeyFrame |= Next.bKeyFrame;
+
+  if(Next.bChangeGopLength)
+  {
+    Cmd.bChangeGopLength = true;
+    Cmd.iGopLength = Next.iGopLength;
+  }
 
-  for(;;)
+  if(Next.bChangeGopNumB)
   {
-    if(!GetNextLine(sLine))
-      break;
+    Cmd.bChangeGopNumB = true;
+    Cmd.iGopNumB = Next.iGopNumB;
+  }
 
-    if(sLine.empty())
-      continue;
+  if(Next.bChangeBitRate)
+  {
+    Cmd.bChangeBitRate = true;
+    Cmd.iBitRate = Next.iBitRate;
+  }
 
-    if(ParseCmd(sLine, Cmd, bRet))
-    {
-      bRet = true;
-    }
-    else
-    {
-      m_sBufferedLine = sLine;
-      break;
-    }
+  if(Next.bChangeFrameRate)
+  {
+    Cmd.bChangeFrameRate = true;
+    Cmd.iFrameRate = Next.iFrameRate;
+    Cmd.iClkRatio = Next.iClkRatio;
   }
 
-  return bRet;
+  if(Next.bChangeQP)
+  {
+    Cmd.bChangeQP = true;
+    Cmd.iQP = Next.iQP;
+  }
 }
 
 /****************************************************************************/
-bool CEncCmdMngr::GetNextLine(string& sNextLine)
+CEncCmdMngr::TFrmCmd const* CEncCmdMngr::Find(int iFrame, size_t& zCursor) const
 {
-  bool bSucceed = true;
+  // frames are requested in increasing order: the cursor only moves forward in the common case
+  if(zCursor > 0 && (zCursor > m_Cmds.size() || m_Cmds[zCursor - 1].iFrame >= iFrame))
+    zCursor = lower_bound(m_Cmds.begin(), m_Cmds.end(), iFrame, [](TFrmCmd const& Cmd, int i) { return Cmd.iFrame < i; }) - m_Cmds.begin();
 
-  if(!m_sBufferedLine.empty())
-  {
-    sNextLine = m_sBufferedLine;
-    m_sBufferedLine.clear();
-  }
-  else
-  {
-    getline(m_CmdInput, sNextLine);
-    bSucceed = !m_CmdInput.fail();
-  }
+  while(zCursor < m_Cmds.size() && m_Cmds[zCursor].iFrame < iFrame)
+    ++zCursor;
+
+  if(zCursor < m_Cmds.size() && m_Cmds[zCursor].iFrame == iFrame)
+    return &m_Cmds[zCursor];
 
-  return bSucceed;
+  return nullptr;
 }
 
 /****************************************************************************/
-bool CEncCmdMngr::ParseCmd(std::string sLine, TFrmCmd& Cmd, bool bSameFrame)
+bool CEncCmdMngr::ParseCmd(std::string const& sLine, TFrmCmd& Cmd, bool bSameFrame)
 {
   CCmdTokenizer Tok(sLine);
 
@@ -243,55 +266,46 @@ bool CEncCmdMngr::ParseCmd(std::string sLine, TFrmCmd& Cmd, bool bSameFrame)
 /****************************************************************************/
 void CEncCmdMngr::Process(ICommandsSender* sender, int iFrame)
 {
-  if(!m_Cmds.empty())
+  // Look ahead command
+  if(m_iLookAhead)
   {
-    bool bRefill = false;
-
-    // Look ahead command
-    if(iFrame + m_iLookAhead == m_Cmds.back().iFrame)
-    {
-      bRefill = true;
+    auto pCmd = Find(iFrame + m_iLookAhead, m_zLookAheadCursor);
 
-      if(m_Cmds.back().bSceneChange)
-        sender->notifySceneChange(m_iLookAhead);
-    }
+    if(pCmd && pCmd->bSceneChange)
+      sender->notifySceneChange(m_iLookAhead);
+  }
 
-    // On time command
-    if(iFrame == m_Cmds.front().iFrame)
-    {
-      bRefill = true;
+  // On time command
+  auto pCmd = Find(iFrame, m_zOnTimeCursor);
 
-      if(m_Cmds.front().bUseLongTerm && (m_iFreqLT || m_bHasLT))
-        sender->notifyUseLongTerm();
+  if(!pCmd)
+    return;
 
-      if(m_Cmds.front().bIsLongTerm)
-      {
-        sender->notifyIsLongTerm();
-        m_bHasLT = true;
-      }
+  if(pCmd->bUseLongTerm && (m_iFreqLT || m_bHasLT))
+    sender->notifyUseLongTerm();
 
+  if(pCmd->bIsLongTerm)
+  {
+    sender->notifyIsLongTerm();
+    m_bHasLT = true;
+  }
 
-      if(m_Cmds.front().bKeyFrame)
-        sender->restartGop();
 
-      if(m_Cmds.front().bChangeGopLength)
-        sender->setGopLength(m_Cmds.front().iGopLength);
+  if(pCmd->bKeyFrame)
+    sender->restartGop();
 
-      if(m_Cmds.front().bChangeGopNumB)
-        sender->setNumB(m_Cmds.front().iGopNumB);
+  if(pCmd->bChangeGopLength)
+    sender->setGopLength(pCmd->iGopLength);
 
-      if(m_Cmds.front().bChangeFrameRate)
-        sender->setFrameRate(m_Cmds.front().iFrameRate, m_Cmds.front().iClkRatio);
+  if(pCmd->bChangeGopNumB)
+    sender->setNumB(pCmd->iGopNumB);
 
-      if(m_Cmds.front().bChangeBitRate)
-        sender->setBitRate(m_Cmds.front().iBitRate);
+  if(pCmd->bChangeFrameRate)
+    sender->setFrameRate(pCmd->iFrameRate, pCmd->iClkRatio);
 
-      if(m_Cmds.front().bChangeQP)
-        sender->setQP(m_Cmds.front().iQP);
-    }
+  if(pCmd->bChangeBitRate)
+    sender->setBitRate(pCmd->iBitRate);
 
-    if(bRefill)
-      Refill(iFrame + 1);
-  }
+  if(pCmd->bChangeQP)
+    sender->setQP(pCmd->iQP);
 }
-
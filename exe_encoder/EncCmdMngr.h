@@ -37,7 +37,7 @@
 
 #pragma once
 
-#include <list>
+#include <vector>
 #include <iostream>
 #include <string>
 
@@ -71,17 +71,17 @@ private:
     int iQP = 0;
   };
 
-  void Refill(int iCurFrame);
-  bool ReadNextCmd(TFrmCmd& Cmd);
-  bool ParseCmd(std::string sLine, TFrmCmd& Cmd, bool bSameFrame);
-  bool GetNextLine(std::string& sNextLine);
+  void Compile(std::istream& CmdInput);
+  bool ParseCmd(std::string const& sLine, TFrmCmd& Cmd, bool bSameFrame);
+  static void Merge(TFrmCmd& Cmd, TFrmCmd const& Next);
+  TFrmCmd const* Find(int iFrame, size_t& zCursor) const;
 
 private:
-  std::istream& m_CmdInput;
   int const m_iLookAhead;
   int const m_iFreqLT;
   bool m_bHasLT;
-  std::list<TFrmCmd> m_Cmds;
-  std::string m_sBufferedLine;
+  std::vector<TFrmCmd> m_Cmds; // one record per frame, sorted by frame
+  size_t m_zOnTimeCursor;
+  size_t m_zLookAheadCursor;
 };
 
@@ -66,9 +66,10 @@ extern "C"
 {
 #include "lib_encode/SchedulerMcu.h"
 #include "lib_common/HardwareDriver.h"
+#include "lib_common/EventReactor.h"
 }
 
-static unique_ptr<CIpDevice> createMcuIpDevice()
+static unique_ptr<CIpDevice> createMcuIpDevice(bool bUseReactor)
 {
   auto device = make_unique<CIpDevice>();
 
@@ -77,7 +78,15 @@ static unique_ptr<CIpDevice> createMcuIpDevice()
   if(!device->m_pAllocator)
     throw runtime_error("Can't open DMA allocator");
 
-  device->m_pScheduler = AL_SchedulerMcu_Create(AL_GetHardwareDriver(), device->m_pAllocator.get());
+  if(bUseReactor)
+  {
+    device->m_pReactor.reset(AL_EventReactor_Create(1), &AL_EventReactor_Destroy);
+
+    if(!device->m_pReactor)
+      throw runtime_error("Can't create event reactor");
+  }
+
+  device->m_pScheduler = AL_SchedulerMcu_CreateWithReactor(AL_GetHardwareDriver(), device->m_pAllocator.get(), device->m_pReactor.get());
 
   if(!device->m_pScheduler)
     throw std::runtime_error("Failed to create MCU scheduler");
@@ -93,7 +102,10 @@ shared_ptr<CIpDevice> CreateIpDevice(bool bUseRefSoftware, int iSchedulerType, A
 
 
   if(iSchedulerType == SCHEDULER_TYPE_MCU)
-    return createMcuIpDevice();
+    return createMcuIpDevice(false);
+
+  if(iSchedulerType == SCHEDULER_TYPE_MCU_REACTOR)
+    return createMcuIpDevice(true);
 
   throw runtime_error("No support for this scheduling type");
 }
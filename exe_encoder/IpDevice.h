@@ -50,12 +50,14 @@ extern "C"
 typedef struct AL_t_Allocator AL_TAllocator;
 typedef struct AL_t_IpCtrl AL_TIpCtrl;
 typedef struct AL_t_Timer AL_Timer;
+typedef struct AL_t_EventReactor AL_TEventReactor;
 
 /*****************************************************************************/
 struct CIpDevice
 {
   TScheduler* m_pScheduler = nullptr;
   std::shared_ptr<AL_TAllocator> m_pAllocator;
+  std::shared_ptr<AL_TEventReactor> m_pReactor;
   AL_Timer* m_pTimer;
 };
 
@@ -102,11 +102,13 @@ void CMD5::Update(uint8_t* pBuffer, uint32_t uSize)
     m_uBound = 0;
   }
 
-  while(uSize >= sizeof(m_pBound))
+  uint32_t uNumBlocks = uSize / sizeof(m_pBound);
+
+  if(uNumBlocks)
   {
-    UpdateBlock(reinterpret_cast<uint32_t*>(pBuffer));
-    pBuffer += sizeof(m_pBound);
-    uSize -= sizeof(m_pBound);
+    UpdateBlocks(reinterpret_cast<uint32_t*>(pBuffer), uNumBlocks);
+    pBuffer += uNumBlocks * sizeof(m_pBound);
+    uSize -= uNumBlocks * sizeof(m_pBound);
   }
 
   while(uSize--)
@@ -153,82 +155,102 @@ std::string CMD5::GetMD5()
 /*************************************************************************************/
 void CMD5::UpdateBlock(uint32_t* pBlock)
 {
-  uint32_t a = m_pHash32[0];
-  uint32_t b = m_pHash32[1];
-  uint32_t c = m_pHash32[2];
-  uint32_t d = m_pHash32[3];
-
-  MD5(a, b, c, d, F, 0, 0xD76AA478, 7);
-  MD5(d, a, b, c, F, 1, 0xE8C7B756, 12);
-  MD5(c, d, a, b, F, 2, 0x242070DB, 17);
-  MD5(b, c, d, a, F, 3, 0xC1BDCEEE, 22);
-  MD5(a, b, c, d, F, 4, 0xF57C0FAF, 7);
-  MD5(d, a, b, c, F, 5, 0x4787C62A, 12);
-  MD5(c, d, a, b, F, 6, 0xA8304613, 17);
-  MD5(b, c, d, a, F, 7, 0xFD469501, 22);
-  MD5(a, b, c, d, F, 8, 0x698098D8, 7);
-  MD5(d, a, b, c, F, 9, 0x8B44F7AF, 12);
-  MD5(c, d, a, b, F, 10, 0xFFFF5BB1, 17);
-  MD5(b, c, d, a, F, 11, 0x895CD7BE, 22);
-  MD5(a, b, c, d, F, 12, 0x6B901122, 7);
-  MD5(d, a, b, c, F, 13, 0xFD987193, 12);
-  MD5(c, d, a, b, F, 14, 0xA679438E, 17);
-  MD5(b, c, d, a, F, 15, 0x49B40821, 22);
-
-  MD5(a, b, c, d, G, 1, 0xF61E2562, 5);
-  MD5(d, a, b, c, G, 6, 0xC040B340, 9);
-  MD5(c, d, a, b, G, 11, 0x265E5A51, 14);
-  MD5(b, c, d, a, G, 0, 0xE9B6C7AA, 20);
-  MD5(a, b, c, d, G, 5, 0xD62F105D, 5);
-  MD5(d, a, b, c, G, 10, 0x02441453, 9);
-  MD5(c, d, a, b, G, 15, 0xD8A1E681, 14);
-  MD5(b, c, d, a, G, 4, 0xE7D3FBC8, 20);
-  MD5(a, b, c, d, G, 9, 0x21E1CDE6, 5);
-  MD5(d, a, b, c, G, 14, 0xC33707D6, 9);
-  MD5(c, d, a, b, G, 3, 0xF4D50D87, 14);
-  MD5(b, c, d, a, G, 8, 0x455A14ED, 20);
-  MD5(a, b, c, d, G, 13, 0xA9E3E905, 5);
-  MD5(d, a, b, c, G, 2, 0xFCEFA3F8, 9);
-  MD5(c, d, a, b, G, 7, 0x676F02D9, 14);
-  MD5(b, c, d, a, G, 12, 0x8D2A4C8A, 20);
-
-  MD5(a, b, c, d, H, 5, 0xFFFA3942, 4);
-  MD5(d, a, b, c, H, 8, 0x8771F681, 11);
-  MD5(c, d, a, b, H, 11, 0x6D9D6122, 16);
-  MD5(b, c, d, a, H, 14, 0xFDE5380C, 23);
-  MD5(a, b, c, d, H, 1, 0xA4BEEA44, 4);
-  MD5(d, a, b, c, H, 4, 0x4BDECFA9, 11);
-  MD5(c, d, a, b, H, 7, 0xF6BB4B60, 16);
-  MD5(b, c, d, a, H, 10, 0xBEBFBC70, 23);
-  MD5(a, b, c, d, H, 13, 0x289B7EC6, 4);
-  MD5(d, a, b, c, H, 0, 0xEAA127FA, 11);
-  MD5(c, d, a, b, H, 3, 0xD4EF3085, 16);
-  MD5(b, c, d, a, H, 6, 0x04881D05, 23);
-  MD5(a, b, c, d, H, 9, 0xD9D4D039, 4);
-  MD5(d, a, b, c, H, 12, 0xE6DB99E5, 11);
-  MD5(c, d, a, b, H, 15, 0x1FA27CF8, 16);
-  MD5(b, c, d, a, H, 2, 0xC4AC5665, 23);
-
-  MD5(a, b, c, d, I, 0, 0xF4292244, 6);
-  MD5(d, a, b, c, I, 7, 0x432AFF97, 10);
-  MD5(c, d, a, b, I, 14, 0xAB9423A7, 15);
-  MD5(b, c, d, a, I, 5, 0xFC93A039, 21);
-  MD5(a, b, c, d, I, 12, 0x655B59C3, 6);
-  MD5(d, a, b, c, I, 3, 0x8F0CCC92, 10);
-  MD5(c, d, a, b, I, 10, 0xFFEFF47D, 15);
-  MD5(b, c, d, a, I, 1, 0x85845DD1, 21);
-  MD5(a, b, c, d, I, 8, 0x6FA87E4F, 6);
-  MD5(d, a, b, c, I, 15, 0xFE2CE6E0, 10);
-  MD5(c, d, a, b, I, 6, 0xA3014314, 15);
-  MD5(b, c, d, a, I, 13, 0x4E0811A1, 21);
-  MD5(a, b, c, d, I, 4, 0xF7537E82, 6);
-  MD5(d, a, b, c, I, 11, 0xBD3AF235, 10);
-  MD5(c, d, a, b, I, 2, 0x2AD7D2BB, 15);
-  MD5(b, c, d, a, I, 9, 0xEB86D391, 21);
-
-  m_pHash32[0] += a;
-  m_pHash32[1] += b;
-  m_pHash32[2] += c;
-  m_pHash32[3] += d;
+  UpdateBlocks(pBlock, 1);
+}
+
+/*************************************************************************************/
+void CMD5::UpdateBlocks(uint32_t* pBlock, uint32_t uNumBlocks)
+{
+  // the chaining values stay in registers from one block to the next
+  uint32_t a0 = m_pHash32[0];
+  uint32_t b0 = m_pHash32[1];
+  uint32_t c0 = m_pHash32[2];
+  uint32_t d0 = m_pHash32[3];
+
+  for(; uNumBlocks; --uNumBlocks, pBlock += 16)
+  {
+    uint32_t a = a0;
+    uint32_t b = b0;
+    uint32_t c = c0;
+    uint32_t d = d0;
+
+    MD5(a, b, c, d, F, 0, 0xD76AA478, 7);
+    MD5(d, a, b, c, F, 1, 0xE8C7B756, 12);
+    MD5(c, d, a, b, F, 2, 0x242070DB, 17);
+    MD5(b, c, d, a, F, 3, 0xC1BDCEEE, 22);
+    MD5(a, b, c, d, F, 4, 0xF57C0FAF, 7);
+    MD5(d, a, b, c, F, 5, 0x4787C62A, 12);
+    MD5(c, d, a, b, F, 6, 0xA8304613, 17);
+    MD5(b, c, d, a, F, 7, 0xFD469501, 22);
+    MD5(a, b, c, d, F, 8, 0x698098D8, 7);
+    MD5(d, a, b, c, F, 9, 0x8B44F7AF, 12);
+    MD5(c, d, a, b, F, 10, 0xFFFF5BB1, 17);
+    MD5(b, c, d, a, F, 11, 0x895CD7BE, 22);
+    MD5(a, b, c, d, F, 12, 0x6B901122, 7);
+    MD5(d, a, b, c, F, 13, 0xFD987193, 12);
+    MD5(c, d, a, b, F, 14, 0xA679438E, 17);
+    MD5(b, c, d, a, F, 15, 0x49B40821, 22);
+
+    MD5(a, b, c, d, G, 1, 0xF61E2562, 5);
+    MD5(d, a, b, c, G, 6, 0xC040B340, 9);
+    MD5(c, d, a, b, G, 11, 0x265E5A51, 14);
+    MD5(b, c, d, a, G, 0, 0xE9B6C7AA, 20);
+    MD5(a, b, c, d, G, 5, 0xD62F105D, 5);
+    MD5(d, a, b, c, G, 10, 0x02441453, 9);
+    MD5(c, d, a, b, G, 15, 0xD8A1E681, 14);
+    MD5(b, c, d, a, G, 4, 0xE7D3FBC8, 20);
+    MD5(a, b, c, d, G, 9, 0x21E1CDE6, 5);
+    MD5(d, a, b, c, G, 14, 0xC33707D6, 9);
+    MD5(c, d, a, b, G, 3, 0xF4D50D87, 14);
+    MD5(b, c, d, a, G, 8, 0x455A14ED, 20);
+    MD5(a, b, c, d, G, 13, 0xA9E3E905, 5);
+    MD5(d, a, b, c, G, 2, 0xFCEFA3F8, 9);
+    MD5(c, d, a, b, G, 7, 0x676F02D9, 14);
+    MD5(b, c, d, a, G, 12, 0x8D2A4C8A, 20);
+
+    MD5(a, b, c, d, H, 5, 0xFFFA3942, 4);
+    MD5(d, a, b, c, H, 8, 0x8771F681, 11);
+    MD5(c, d, a, b, H, 11, 0x6D9D6122, 16);
+    MD5(b, c, d, a, H, 14, 0xFDE5380C, 23);
+    MD5(a, b, c, d, H, 1, 0xA4BEEA44, 4);
+    MD5(d, a, b, c, H, 4, 0x4BDECFA9, 11);
+    MD5(c, d, a, b, H, 7, 0xF6BB4B60, 16);
+    MD5(b, c, d, a, H, 10, 0xBEBFBC70, 23);
+    MD5(a, b, c, d, H, 13, 0x289B7EC6, 4);
+    MD5(d, a, b, c, H, 0, 0xEAA127FA, 11);
+    MD5(c, d, a, b, H, 3, 0xD4EF3085, 16);
+    MD5(b, c, d, a, H, 6, 0x04881D05, 23);
+    MD5(a, b, c, d, H, 9, 0xD9D4D039, 4);
+    MD5(d, a, b, c, H, 12, 0xE6DB99E5, 11);
+    MD5(c, d, a, b, H, 15, 0x1FA27CF8, 16);
+    MD5(b, c, d, a, H, 2, 0xC4AC5665, 23);
+
+    MD5(a, b, c, d, I, 0, 0xF4292244, 6);
+    MD5(d, a, b, c, I, 7, 0x432AFF97, 10);
+    MD5(c, d, a, b, I, 14, 0xAB9423A7, 15);
+    MD5(b, c, d, a, I, 5, 0xFC93A039, 21);
+    MD5(a, b, c, d, I, 12, 0x655B59C3, 6);
+    MD5(d, a, b, c, I, 3, 0x8F0CCC92, 10);
+    MD5(c, d, a, b, I, 10, 0xFFEFF47D, 15);
+    MD5(b, c, d, a, I, 1, 0x85845DD1, 21);
+    MD5(a, b, c, d, I, 8, 0x6FA87E4F, 6);
+    MD5(d, a, b, c, I, 15, 0xFE2CE6E0, 10);
+    MD5(c, d, a, b, I, 6, 0xA3014314, 15);
+    MD5(b, c, d, a, I, 13, 0x4E0811A1, 21);
+    MD5(a, b, c, d, I, 4, 0xF7537E82, 6);
+    MD5(d, a, b, c, I, 11, 0xBD3AF235, 10);
+    MD5(c, d, a, b, I, 2, 0x2AD7D2BB, 15);
+    MD5(b, c, d, a, I, 9, 0xEB86D391, 21);
+
+    a0 += a;
+    b0 += b;
+    c0 += c;
+    d0 += d;
+  }
+
+  m_pHash32[0] = a0;
+  m_pHash32[1] = b0;
+  m_pHash32[2] = c0;
+  m_pHash32[3] = d0;
 }
 
@@ -50,6 +50,7 @@ public:
 
 protected:
   void UpdateBlock(uint32_t* pBlock);
+  void UpdateBlocks(uint32_t* pBlock, uint32_t uNumBlocks);
 
   union
   {
@@ -105,10 +105,7 @@ void Generate_RampQP(uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iNumByte
 
   for(int iLCU = 0; iLCU < iNumLCUs; iLCU++)
   {
-    int iFirst = iNumBytesPerLCU * iLCU;
-
-    for(int iQP = 0; iQP < iNumQPPerLCU; ++iQP)
-      pQPs[iFirst + iQP] = s_iQP & MASK_QP;
+    AL_RoiMngr_FillLCUs(pQPs + iNumBytesPerLCU * iLCU, 1, iNumQPPerLCU, iNumBytesPerLCU, s_iQP & MASK_QP);
 
     if(++s_iQP > iMaxQP)
       s_iQP = iMinQP;
@@ -187,9 +184,6 @@ void Generate_BorderQP(uint8_t* pQPs, int iNumLCUs, int iLCUWidth, int iLCUHeigh
   const int iLastY2 = iLCUHeight - 1;
   const int iLastY1 = iLCUHeight - 2;
 
-  int iFirstLCU = 0;
-  int iLastLCU = iNumLCUs - 1;
-
   if(iQP2 > iMaxQP)
     iQP2 = iMaxQP;
   iQP1 = iQP0 + 1;
@@ -197,22 +191,30 @@ void Generate_BorderQP(uint8_t* pQPs, int iNumLCUs, int iLCUWidth, int iLCUHeigh
   if(iQP1 > iMaxQP)
     iQP1 = iMaxQP;
 
-  for(int iLCU = iFirstLCU; iLCU <= iLastLCU; iLCU++)
+  assert(iNumLCUs == iLCUWidth * iLCUHeight);
+  (void)iNumLCUs;
+
+  for(int Y = 0; Y < iLCUHeight; ++Y)
   {
-    int X = iLCU % iLCUWidth;
-    int Y = iLCU / iLCUWidth;
+    uint8_t* pRow = pQPs + iNumBytesPerLCU * Y * iLCUWidth;
 
-    int iFirst = iNumBytesPerLCU * iLCU;
+    if(Y == iFirstY2 || Y >= iLastY2)
+    {
+      AL_RoiMngr_FillLCUs(pRow, iLCUWidth, iNumQPPerLCU, iNumBytesPerLCU, iQP2);
+      continue;
+    }
 
-    if(X == iFirstX2 || Y == iFirstY2 || X == iLastX2 || Y >= iLastY2)
-      pQPs[iFirst] = iQP2;
-    else if(X == iFirstX1 || Y == iFirstY1 || X == iLastX1 || Y == iLastY1)
-      pQPs[iFirst] = iQP1;
-    else
-      pQPs[iFirst] = iQP0;
+    AL_RoiMngr_FillLCUs(pRow, iLCUWidth, iNumQPPerLCU, iNumBytesPerLCU, (Y == iFirstY1 || Y == iLastY1) ? iQP1 : iQP0);
 
-    for(int iQP = 1; iQP < iNumQPPerLCU; ++iQP)
-      pQPs[iFirst + iQP] = pQPs[iFirst];
+    // inner border columns first, so that the outer ones take precedence on narrow pictures
+    if(iFirstX1 < iLCUWidth)
+      AL_RoiMngr_FillLCUs(pRow + iNumBytesPerLCU * iFirstX1, 1, iNumQPPerLCU, iNumBytesPerLCU, iQP1);
+
+    if(iLastX1 >= 0)
+      AL_RoiMngr_FillLCUs(pRow + iNumBytesPerLCU * iLastX1, 1, iNumQPPerLCU, iNumBytesPerLCU, iQP1);
+
+    AL_RoiMngr_FillLCUs(pRow + iNumBytesPerLCU * iFirstX2, 1, iNumQPPerLCU, iNumBytesPerLCU, iQP2);
+    AL_RoiMngr_FillLCUs(pRow + iNumBytesPerLCU * iLastX2, 1, iNumQPPerLCU, iNumBytesPerLCU, iQP2);
   }
 }
 
@@ -376,6 +378,138 @@ bool Load_QPTable_FromFile(uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iN
   return true;
 }
 
+/****************************************************************************/
+QPTablesPrefetcher::~QPTablesPrefetcher()
+{
+  {
+    lock_guard<mutex> lock(mtx);
+    bExit = true;
+  }
+  cv.notify_all();
+
+  if(worker.joinable())
+    worker.join();
+}
+
+/****************************************************************************/
+void QPTablesPrefetcher::SetFolder(string const& sQPTablesFolder)
+{
+  lock_guard<mutex> lock(mtx);
+  sFolder = sQPTablesFolder;
+  Restart(iFirstFrame);
+}
+
+/****************************************************************************/
+void QPTablesPrefetcher::Restart(int iFrameID)
+{
+  ++iGeneration;
+  iFirstFrame = iFrameID;
+  iNextFrame = iFrameID;
+
+  for(auto& slot : slots)
+    slot.iFrameID = -1;
+
+  cv.notify_all();
+}
+
+/****************************************************************************/
+bool QPTablesPrefetcher::Load(uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU, int iFrameID)
+{
+  return Fetch(nullptr, pQPs, iNumLCUs, iNumQPPerLCU, iNumBytesPerLCU, false, false, iFrameID);
+}
+
+/****************************************************************************/
+bool QPTablesPrefetcher::LoadVp9(uint8_t* pSegs, uint8_t* pQPs, int iNumLCUs, int iFrameID, bool bRelative)
+{
+  return Fetch(pSegs, pQPs, iNumLCUs, 1, 1, true, bRelative, iFrameID);
+}
+
+/****************************************************************************/
+bool QPTablesPrefetcher::Fetch(uint8_t* pSegs, uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU, bool bAOM, bool bRelative, int iFrameID)
+{
+  assert(iFrameID >= 0);
+  unique_lock<mutex> lock(mtx);
+
+  if(!worker.joinable())
+    worker = thread(&QPTablesPrefetcher::Run, this);
+
+  bool bSameLayout = (this->iNumLCUs == iNumLCUs) && (this->iNumQPPerLCU == iNumQPPerLCU) && (this->iNumBytesPerLCU == iNumBytesPerLCU) &&
+                     (this->bAOM == bAOM) && (this->bRelative == bRelative);
+
+  if(!bSameLayout)
+  {
+    this->iNumLCUs = iNumLCUs;
+    this->iNumQPPerLCU = iNumQPPerLCU;
+    this->iNumBytesPerLCU = iNumBytesPerLCU;
+    this->bAOM = bAOM;
+    this->bRelative = bRelative;
+    Restart(iFrameID);
+  }
+  else if(iFrameID < iFirstFrame || iFrameID >= iFirstFrame + DEPTH)
+    Restart(iFrameID);
+
+  TSlot& slot = slots[iFrameID % DEPTH];
+  cv.wait(lock, [&] { return slot.iFrameID == iFrameID; });
+
+  if(slot.bFound)
+  {
+    Rtos_Memcpy(pQPs, slot.QPs.data(), slot.QPs.size());
+
+    if(bAOM)
+      Rtos_Memcpy(pSegs, slot.Segs.data(), SEGS_SIZE);
+  }
+  bool bFound = slot.bFound;
+
+  // the frames up to this one won't be requested anymore, their slots can be refilled
+  iFirstFrame = iFrameID + 1;
+  cv.notify_all();
+
+  return bFound;
+}
+
+/****************************************************************************/
+void QPTablesPrefetcher::Run()
+{
+  vector<uint8_t> QPs;
+  vector<uint8_t> Segs;
+  unique_lock<mutex> lock(mtx);
+
+  while(true)
+  {
+    cv.wait(lock, [&] { return bExit || iNextFrame < iFirstFrame + DEPTH; });
+
+    if(bExit)
+      return;
+
+    int iGen = iGeneration;
+    int iFrameID = iNextFrame;
+    string sFolderCopy = sFolder;
+    int iNumLCUsCopy = iNumLCUs;
+    int iNumQPPerLCUCopy = iNumQPPerLCU;
+    int iNumBytesPerLCUCopy = iNumBytesPerLCU;
+    bool bAOMCopy = bAOM;
+    bool bRelativeCopy = bRelative;
+
+    lock.unlock();
+    QPs.assign(iNumLCUsCopy * iNumBytesPerLCUCopy, 0);
+    Segs.assign(SEGS_SIZE, 0);
+    bool bFound = bAOMCopy ? Load_QPTable_FromFile_Vp9(Segs.data(), QPs.data(), iNumLCUsCopy, sFolderCopy, iFrameID, bRelativeCopy) :
+                  Load_QPTable_FromFile(QPs.data(), iNumLCUsCopy, iNumQPPerLCUCopy, iNumBytesPerLCUCopy, sFolderCopy, iFrameID);
+    lock.lock();
+
+    if(iGen != iGeneration)
+      continue;
+
+    TSlot& slot = slots[iFrameID % DEPTH];
+    slot.QPs.swap(QPs);
+    slot.Segs.swap(Segs);
+    slot.bFound = bFound;
+    slot.iFrameID = iFrameID;
+    ++iNextFrame;
+    cv.notify_all();
+  }
+}
+
 /****************************************************************************/
 static bool get_motif(char* sLine, string motif, int& iPos)
 {
@@ -403,21 +537,6 @@ static int get_id(char* sLine, int iPos)
   return iID;
 }
 
-/****************************************************************************/
-static bool check_frame_id(char* sLine, int iFrameID)
-{
-  int iPos;
-
-  if(get_motif(sLine, "frame", iPos))
-  {
-    int iID = get_id(sLine, iPos);
-
-    if(iID == iFrameID)
-      return true;
-  }
-  return false;
-}
-
 /****************************************************************************/
 string getStringOnKeyword(char* sLine, int iPos)
 {
@@ -463,32 +582,6 @@ static AL_ERoiOrder get_roi_order(char* sLine, int iPos)
   return AL_ROI_QUALITY_ORDER;
 }
 
-/****************************************************************************/
-static bool ReadRoiHdr(ifstream& RoiFile, int iFrameID, AL_ERoiQuality& eBkgQuality, AL_ERoiOrder& eRoiOrder)
-{
-  char sLine[256];
-  bool bFind = false;
-
-  while(!bFind && !RoiFile.eof())
-  {
-    RoiFile.getline(sLine, 256);
-    bFind = check_frame_id(sLine, iFrameID);
-
-    if(bFind)
-    {
-      int iPos;
-
-      if(get_motif(sLine, "BkgQuality", iPos))
-        eBkgQuality = get_roi_quality(sLine, iPos);
-
-      if(get_motif(sLine, "Order", iPos))
-        eRoiOrder = get_roi_order(sLine, iPos);
-    }
-  }
-
-  return bFind;
-}
-
 /****************************************************************************/
 static bool line_is_empty(char* sLine)
 {
@@ -525,59 +618,115 @@ static void get_dual_value(char* sLine, char separator, int& iPos, int& iValue1,
 }
 
 /****************************************************************************/
-static bool get_new_roi(ifstream& RoiFile, int& iPosX, int& iPosY, int& iWidth, int& iHeight, AL_ERoiQuality& eQuality)
+static void read_roi_hdr(char* sLine, TRoiSection& section)
+{
+  int iPos;
+
+  if(get_motif(sLine, "BkgQuality", iPos))
+  {
+    section.bHasBkgQuality = true;
+    section.eBkgQuality = get_roi_quality(sLine, iPos);
+  }
+
+  if(get_motif(sLine, "Order", iPos))
+  {
+    section.bHasOrder = true;
+    section.eOrder = get_roi_order(sLine, iPos);
+  }
+}
+
+/****************************************************************************/
+static TRoiSection::TRoi read_roi(char* sLine)
 {
+  TRoiSection::TRoi roi;
+  int iPos = 0;
+  get_dual_value(sLine, ':', iPos, roi.iPosX, roi.iPosY);
+  get_dual_value(sLine, 'x', iPos, roi.iWidth, roi.iHeight);
+  roi.eQuality = get_roi_quality(sLine, iPos);
+  return roi;
+}
+
+/****************************************************************************/
+bool RoiFileIndex::Load(string const& sRoiFileName)
+{
+  sections.clear();
+  bLoaded = false;
+
+  ifstream file(sRoiFileName);
+
+  if(!file.is_open())
+    return false;
+
+  // A section starts on a line holding "frame <id>" and holds the non empty lines up to the next one.
+  // When a frame is described several times, the first description is used.
   char sLine[256];
-  bool bFind = false;
+  TRoiSection* pSection = nullptr;
 
-  while(!RoiFile.eof())
+  while(file.getline(sLine, 256))
   {
-    RoiFile.getline(sLine, 256);
     int iPos;
 
     if(get_motif(sLine, "frame", iPos))
-      return bFind;
-
-    if(!line_is_empty(sLine))
     {
-      iPos = 0;
-      get_dual_value(sLine, ':', iPos, iPosX, iPosY);
-      get_dual_value(sLine, 'x', iPos, iWidth, iHeight);
-      eQuality = get_roi_quality(sLine, iPos);
-      return true;
+      auto inserted = sections.emplace(get_id(sLine, iPos), TRoiSection());
+      pSection = inserted.second ? &inserted.first->second : nullptr;
+
+      if(pSection)
+        read_roi_hdr(sLine, *pSection);
     }
+    else if(pSection && !line_is_empty(sLine))
+      pSection->rois.push_back(read_roi(sLine));
   }
 
-  return false;
+  bLoaded = true;
+  return true;
 }
 
 /****************************************************************************/
-bool Load_QPTable_FromRoiFile(AL_TRoiMngrCtx* pCtx, string const& sRoiFileName, uint8_t* pQPs, int iFrameID, int iNumQPPerLCU, int iNumBytesPerLCU)
+TRoiSection const* RoiFileIndex::Find(int iFrameID) const
 {
-  ifstream file(sRoiFileName);
+  auto it = sections.find(iFrameID);
+  return it == sections.end() ? nullptr : &it->second;
+}
 
-  if(!file.is_open())
+/****************************************************************************/
+bool Load_QPTable_FromRoiFile(AL_TRoiMngrCtx* pCtx, RoiFileIndex const& roiFile, uint8_t* pQPs, int iFrameID, int iNumQPPerLCU, int iNumBytesPerLCU)
+{
+  if(!roiFile.IsLoaded())
     return false;
 
-  bool bHasData = ReadRoiHdr(file, iFrameID, pCtx->eBkgQuality, pCtx->eOrder);
-
-  if(bHasData)
+  // frames the file doesn't describe reuse the regions of interest of the previous one
+  if(auto pSection = roiFile.Find(iFrameID))
   {
+    if(pSection->bHasBkgQuality)
+      pCtx->eBkgQuality = pSection->eBkgQuality;
+
+    if(pSection->bHasOrder)
+      pCtx->eOrder = pSection->eOrder;
+
     AL_RoiMngr_Clear(pCtx);
-    int iPosX = 0, iPosY = 0, iWidth = 0, iHeight = 0;
-    AL_ERoiQuality eQuality;
 
-    while(get_new_roi(file, iPosX, iPosY, iWidth, iHeight, eQuality))
-      AL_RoiMngr_AddROI(pCtx, iPosX, iPosY, iWidth, iHeight, eQuality);
+    for(auto& roi : pSection->rois)
+      AL_RoiMngr_AddROI(pCtx, roi.iPosX, roi.iPosY, roi.iWidth, roi.iHeight, roi.eQuality);
   }
   AL_RoiMngr_FillBuff(pCtx, iNumQPPerLCU, iNumBytesPerLCU, pQPs);
   return true;
 }
 
-
 /****************************************************************************/
 void Generate_FullSkip(uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU)
 {
+  if(iNumQPPerLCU == iNumBytesPerLCU)
+  {
+    // contiguous QPs: a flat loop the compiler can vectorize
+    int iNumQPs = iNumLCUs * iNumQPPerLCU;
+
+    for(int i = 0; i < iNumQPs; ++i)
+      pQPs[i] = (pQPs[i] & ~MASK_FORCE) | MASK_FORCE_MV0;
+
+    return;
+  }
+
   for(int iLCU = 0; iLCU < iNumLCUs; iLCU++)
   {
     int iFirst = iLCU * iNumBytesPerLCU;
@@ -663,16 +812,16 @@ static void GetQPBufferParameters(int iLCUWidth, int iLCUHeight, AL_EProfile ePr
 }
 
 /****************************************************************************/
-bool GenerateROIBuffer(AL_TRoiMngrCtx* pRoiCtx, string const& sRoiFileName, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, int iFrameID, uint8_t* pQPs)
+bool GenerateROIBuffer(AL_TRoiMngrCtx* pRoiCtx, RoiFileIndex const& roiFile, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, int iFrameID, uint8_t* pQPs)
 {
   int iNumQPPerLCU, iNumBytesPerLCU, iNumLCUs;
   GetQPBufferParameters(iLCUWidth, iLCUHeight, eProf, iNumQPPerLCU, iNumBytesPerLCU, iNumLCUs, pQPs);
-  return Load_QPTable_FromRoiFile(pRoiCtx, sRoiFileName, pQPs, iFrameID, iNumQPPerLCU, iNumBytesPerLCU);
+  return Load_QPTable_FromRoiFile(pRoiCtx, roiFile, pQPs, iFrameID, iNumQPPerLCU, iNumBytesPerLCU);
 }
 
 
 /****************************************************************************/
-bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, int16_t iMaxQP, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, const string& sQPTablesFolder, int iFrameID, uint8_t* pQPs, uint8_t* pSegs)
+bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, int16_t iMaxQP, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, const string& sQPTablesFolder, int iFrameID, uint8_t* pQPs, uint8_t* pSegs, QPTablesPrefetcher* pQPTables)
 {
   bool bRet = false;
   int iNumQPPerLCU, iNumBytesPerLCU, iNumLCUs;
@@ -728,8 +877,12 @@ bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, in
   // ------------------------------------------------------------------------
   case LOAD_QP:
   {
-    bRet = bIsAOM ? Load_QPTable_FromFile_Vp9(pSegs, pQPs, iNumLCUs, sQPTablesFolder, iFrameID, bRelative) :
-           Load_QPTable_FromFile(pQPs, iNumLCUs, iNumQPPerLCU, iNumBytesPerLCU, sQPTablesFolder, iFrameID);
+    if(bIsAOM)
+      bRet = pQPTables ? pQPTables->LoadVp9(pSegs, pQPs, iNumLCUs, iFrameID, bRelative) :
+             Load_QPTable_FromFile_Vp9(pSegs, pQPs, iNumLCUs, sQPTablesFolder, iFrameID, bRelative);
+    else
+      bRet = pQPTables ? pQPTables->Load(pQPs, iNumLCUs, iNumQPPerLCU, iNumBytesPerLCU, iFrameID) :
+             Load_QPTable_FromFile(pQPs, iNumLCUs, iNumQPPerLCU, iNumBytesPerLCU, sQPTablesFolder, iFrameID);
   } break;
   }
 
@@ -743,13 +896,7 @@ bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, in
         pSegs[2 * s] = iSliceQP;
 
     else
-      for(int iLCU = 0; iLCU < iNumLCUs; iLCU++)
-      {
-        int iFirst = iLCU * iNumBytesPerLCU;
-
-        for(int iQP = 0; iQP < iNumQPPerLCU; ++iQP)
-          pQPs[iFirst + iQP] = iSliceQP;
-      }
+      AL_RoiMngr_FillLCUs(pQPs, iNumLCUs, iNumQPPerLCU, iNumBytesPerLCU, iSliceQP);
   }
   // ------------------------------------------------------------------------
 
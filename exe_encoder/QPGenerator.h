@@ -40,9 +40,99 @@
 #pragma once
 
 #include "lib_common_enc/Settings.h"
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "ROIMngr.h"
 
+/*************************************************************************//*!
+   \brief Regions of interest of one frame, as described in a ROI file
+*****************************************************************************/
+struct TRoiSection
+{
+  struct TRoi
+  {
+    int iPosX;
+    int iPosY;
+    int iWidth;
+    int iHeight;
+    AL_ERoiQuality eQuality;
+  };
+
+  bool bHasBkgQuality = false;
+  AL_ERoiQuality eBkgQuality = AL_ROI_QUALITY_MAX_ENUM;
+  bool bHasOrder = false;
+  AL_ERoiOrder eOrder = AL_ROI_MAX_ORDER;
+  std::vector<TRoi> rois;
+};
+
+/*************************************************************************//*!
+   \brief ROI file read once and indexed by frame identifier
+*****************************************************************************/
+class RoiFileIndex
+{
+public:
+  /* returns false if the file cannot be opened */
+  bool Load(std::string const& sRoiFileName);
+  bool IsLoaded() const { return bLoaded; }
+  /* returns the section of the frame, nullptr if the file doesn't describe it */
+  TRoiSection const* Find(int iFrameID) const;
+
+private:
+  bool bLoaded = false;
+  std::unordered_map<int, TRoiSection> sections;
+};
+
+/*************************************************************************//*!
+   \brief Parses the QP table files of the upcoming frames in a background
+   thread so that the encoding thread only has to copy them
+*****************************************************************************/
+class QPTablesPrefetcher
+{
+public:
+  ~QPTablesPrefetcher();
+
+  void SetFolder(std::string const& sQPTablesFolder);
+  /* same contract as loading the table synchronously: returns false if there is no QP table file for this frame */
+  bool Load(uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU, int iFrameID);
+  /* AOM flavour: also loads the segment QPs in pSegs */
+  bool LoadVp9(uint8_t* pSegs, uint8_t* pQPs, int iNumLCUs, int iFrameID, bool bRelative);
+
+private:
+  static const int DEPTH = 8;
+  static const int SEGS_SIZE = 8 * sizeof(int16_t);
+
+  struct TSlot
+  {
+    int iFrameID = -1;
+    bool bFound = false;
+    std::vector<uint8_t> QPs;
+    std::vector<uint8_t> Segs;
+  };
+
+  bool Fetch(uint8_t* pSegs, uint8_t* pQPs, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU, bool bAOM, bool bRelative, int iFrameID);
+  void Restart(int iFrameID);
+  void Run();
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::thread worker;
+  bool bExit = false;
+  int iGeneration = 0; // bumped each time the parsed tables become obsolete
+  int iFirstFrame = 0; // oldest frame that can still be requested
+  int iNextFrame = 0; // next frame parsed by the worker
+  std::string sFolder;
+  int iNumLCUs = 0;
+  int iNumQPPerLCU = 0;
+  int iNumBytesPerLCU = 0;
+  bool bAOM = false;
+  bool bRelative = false;
+  TSlot slots[DEPTH];
+};
+
 /*************************************************************************//*!
    \brief Fill QP part of the buffer pointed to by pQP with a QP for each
         Macroblock of the slice.
@@ -59,16 +149,18 @@
    \param[in]  iFrameID   Frame identifier
    \param[out] pQPs       Pointer to the buffer that receives the computed QPs
    \param[out] pSegs      Pointer to the buffer that receives the computed Segments
+   \param[in]  pQPTables  Optional prefetcher used to load the QP table files.
+               When null, the files are parsed synchronously
    \note iMinQp <= iMaxQP
    \return true on success, false on error
 *****************************************************************************/
-bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, int16_t iMaxQP, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, const std::string& sQPTablesFolder, int iFrameID, uint8_t* pQPs, uint8_t* pSegs);
+bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, int16_t iMaxQP, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, const std::string& sQPTablesFolder, int iFrameID, uint8_t* pQPs, uint8_t* pSegs, QPTablesPrefetcher* pQPTables);
 
 /*************************************************************************//*!
    \brief Fill QP part of the buffer pointed to by pQP with a QP for each
         Macroblock of the slice with roi information
    \param[in]  pRoiCtx    Pointer to the roi object holding roi information
-   \param[in]  sRoiFileName path and file name of the ROI description
+   \param[in]  roiFile    ROI description, loaded with RoiFileIndex::Load
    \param[in]  eMode      Specifies the way QP values are computed. see EQpCtrlMode
    \param[in]  iLCUWidth  Width in Lcu Unit of the picture
    \param[in]  iLCUHeight Height in Lcu Unit of the picture
@@ -77,7 +169,7 @@ bool GenerateQPBuffer(AL_EQpCtrlMode eMode, int16_t iSliceQP, int16_t iMinQP, in
    \param[out] pQPs       Pointer to the buffer that receives the computed QPs
    \return true on success, false on error
 *****************************************************************************/
-bool GenerateROIBuffer(AL_TRoiMngrCtx* pRoiCtx, std::string const& sRoiFileName, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, int iFrameID, uint8_t* pQPs);
+bool GenerateROIBuffer(AL_TRoiMngrCtx* pRoiCtx, RoiFileIndex const& roiFile, int iLCUWidth, int iLCUHeight, AL_EProfile eProf, int iFrameID, uint8_t* pQPs);
 
 /****************************************************************************/
 
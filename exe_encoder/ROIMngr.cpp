@@ -120,7 +120,9 @@ static void Insert(AL_TRoiMngrCtx* pCtx, AL_TRoiNode* pNode)
     pNode->pNext = pCur;
     pCur->pPrev = pNode;
 
-    if(pCur == pCtx->pFirstNode)
+    if(pNode->pPrev)
+      pNode->pPrev->pNext = pNode;
+    else
       pCtx->pFirstNode = pNode;
   }
   else
@@ -136,6 +138,34 @@ static int8_t MeanQuality(AL_TRoiMngrCtx* pCtx, uint8_t iDQp1, uint8_t iDQp2)
   return iQP | eMask;
 }
 
+/****************************************************************************/
+void AL_RoiMngr_FillLCUs(uint8_t* pLCU, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU, uint8_t uQP)
+{
+  if(iNumQPPerLCU == iNumBytesPerLCU)
+  {
+    Rtos_Memset(pLCU, uQP, iNumLCUs * iNumBytesPerLCU);
+    return;
+  }
+
+  for(int iLCU = 0; iLCU < iNumLCUs; ++iLCU)
+    Rtos_Memset(pLCU + iLCU * iNumBytesPerLCU, uQP, iNumQPPerLCU);
+}
+
+/****************************************************************************/
+static void MeanQualitySpan(AL_TRoiMngrCtx* pCtx, uint8_t* pLcu1, uint8_t const* pLcu2, int iStride, int iCount, int8_t iQP)
+{
+  // pLcu1 and pLcu2 may be the same span: each LCU only depends on itself
+  int iDQp = GetDQp(iQP);
+  uint8_t uMask = iQP & MASK_FORCE_MV0;
+
+  for(int i = 0; i < iCount; ++i)
+  {
+    uint8_t uLcu2 = pLcu2[i * iStride];
+    int8_t iMean = Clip3((GetDQp(uLcu2) + iDQp) / 2, pCtx->iMinQP, pCtx->iMaxQP) & MASK_QP;
+    pLcu1[i * iStride] = iMean | uMask | (uLcu2 & MASK_FORCE_MV0);
+  }
+}
+
 /****************************************************************************/
 static void UpdateTransitionHorz(AL_TRoiMngrCtx* pCtx, uint8_t* pLcu1, uint8_t* pLcu2, int iNumBytesPerLCU, int iLcuWidth, int iPosX, int iWidth, int8_t iQP)
 {
@@ -146,8 +176,7 @@ static void UpdateTransitionHorz(AL_TRoiMngrCtx* pCtx, uint8_t* pLcu1, uint8_t*
     pLcu1[-iNumBytesPerLCU] = MeanQuality(pCtx, pLcu2[-iNumBytesPerLCU], iQP);
 
   // width
-  for(int w = 0; w < iWidth; ++w)
-    pLcu1[w * iNumBytesPerLCU] = MeanQuality(pCtx, pLcu2[w * iNumBytesPerLCU], iQP);
+  MeanQualitySpan(pCtx, pLcu1, pLcu2, iNumBytesPerLCU, iWidth, iQP);
 
   // right corner
   if(iPosX + iWidth + 2 < iLcuWidth)
@@ -159,12 +188,7 @@ static void UpdateTransitionHorz(AL_TRoiMngrCtx* pCtx, uint8_t* pLcu1, uint8_t*
 /****************************************************************************/
 static void UpdateTransitionVert(AL_TRoiMngrCtx* pCtx, uint8_t* pLcu1, uint8_t* pLcu2, int iNumBytesPerLCU, int iLcuWidth, int iHeight, int8_t iQP)
 {
-  for(int h = 0; h < iHeight; ++h)
-  {
-    *pLcu1 = MeanQuality(pCtx, *pLcu2, iQP);
-    pLcu1 += (iLcuWidth * iNumBytesPerLCU);
-    pLcu2 += (iLcuWidth * iNumBytesPerLCU);
-  }
+  MeanQualitySpan(pCtx, pLcu1, pLcu2, iLcuWidth * iNumBytesPerLCU, iHeight, iQP);
 }
 
 /****************************************************************************/
@@ -179,15 +203,10 @@ static void ComputeROI(AL_TRoiMngrCtx* pCtx, int iNumQPPerLCU, int iNumBytesPerL
 {
   auto* pLCU = pBuf + GetNodePosInBuf(pCtx, pNode->iPosX, pNode->iPosY, iNumBytesPerLCU);
 
-  // Fill Roi
+  // Fill Roi, one row span at a time
   for(int h = 0; h < pNode->iHeight; ++h)
   {
-    for(int w = 0; w < pNode->iWidth; ++w)
-    {
-      for(int i = 0; i < iNumQPPerLCU; ++i)
-        pLCU[w * iNumBytesPerLCU + i] = pNode->iDeltaQP;
-    }
-
+    AL_RoiMngr_FillLCUs(pLCU, pNode->iWidth, iNumQPPerLCU, iNumBytesPerLCU, pNode->iDeltaQP);
     pLCU += iNumBytesPerLCU * pCtx->iLcuWidth;
   }
 
@@ -329,16 +348,9 @@ void AL_RoiMngr_FillBuff(AL_TRoiMngrCtx* pCtx, int iNumQPPerLCU, int iNumBytesPe
 {
   assert(pBuf);
 
-  // Fill background
-  for(int iLCU = 0; iLCU < pCtx->iNumLCUs; iLCU++)
-  {
-    int iFirst = iLCU * iNumBytesPerLCU;
-
-    for(int iQP = 0; iQP < iNumQPPerLCU; ++iQP)
-      pBuf[iFirst + iQP] = GetNewDeltaQP(pCtx->eBkgQuality);
-  }
+  AL_RoiMngr_FillLCUs(pBuf, pCtx->iNumLCUs, iNumQPPerLCU, iNumBytesPerLCU, GetNewDeltaQP(pCtx->eBkgQuality));
 
-  // Fill ROIs
+  // Paint the ROIs in list order: with AL_ROI_QUALITY_ORDER, the best quality ones are painted last
   AL_TRoiNode* pCur = pCtx->pFirstNode;
 
   while(pCur)
@@ -101,3 +101,6 @@ bool AL_RoiMngr_AddROI(AL_TRoiMngrCtx* pCtx, int iPosX, int iPosY, int iWidth, i
 
 void AL_RoiMngr_FillBuff(AL_TRoiMngrCtx* pCtx, int iNumQPPerLCU, int iNumBytesPerLCU, uint8_t* pBuf);
 
+/* Sets the QP of iNumLCUs consecutive LCUs of a QP map to uQP */
+void AL_RoiMngr_FillLCUs(uint8_t* pLCU, int iNumLCUs, int iNumQPPerLCU, int iNumBytesPerLCU, uint8_t uQP);
+
@@ -39,6 +39,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <iostream>
 
 #define SEQUENCE_SIZE_MAX 1000
@@ -109,6 +110,18 @@ int32_t AL_TwoPassMngr_GetIPRatio(AL_TBuffer* pCurrentSrc, AL_TBuffer* pNextSrc)
   return GetIPRatio(pCurrentMeta, pNextMeta);
 }
 
+/***************************************************************************/
+bool AL_TwoPassMngr_SceneChangeDetected(AL_TLookAheadMetaData* pPrevMeta, AL_TLookAheadMetaData* pCurrentMeta)
+{
+  return SceneChangeDetected(pPrevMeta, pCurrentMeta);
+}
+
+/***************************************************************************/
+int32_t AL_TwoPassMngr_GetIPRatio(AL_TLookAheadMetaData* pCurrentMeta, AL_TLookAheadMetaData* pNextMeta)
+{
+  return GetIPRatio(pCurrentMeta, pNextMeta);
+}
+
 /***************************************************************************/
 /*Offline TwoPass methods*/
 /***************************************************************************/
@@ -118,6 +131,7 @@ TwoPassMngr::TwoPassMngr(string p_FileName, int p_iPass)
   iPass = p_iPass;
   iCurrentFrame = 0;
   tFrames.clear();
+  tFrames.reserve(SEQUENCE_SIZE_MAX);
   OpenLog();
 }
 
@@ -145,6 +159,39 @@ void TwoPassMngr::CloseLog()
   outputFile.close();
 }
 
+/***************************************************************************/
+/* Reads the next space separated integer of the line. Same result as strtok(" ") followed by atoi */
+static bool ScanInt(char const*& pCur, int& iValue)
+{
+  while(*pCur == ' ')
+    ++pCur;
+
+  if(*pCur == '\0')
+    return false;
+
+  char const* pToken = pCur;
+
+  while(isspace(static_cast<unsigned char>(*pToken)))
+    ++pToken;
+
+  bool bNegative = (*pToken == '-');
+
+  if(*pToken == '-' || *pToken == '+')
+    ++pToken;
+
+  int iAbs = 0;
+
+  while(*pToken >= '0' && *pToken <= '9')
+    iAbs = 10 * iAbs + (*pToken++ - '0');
+
+  iValue = bNegative ? -iAbs : iAbs;
+
+  while(*pCur != ' ' && *pCur != '\0')
+    ++pCur;
+
+  return true;
+}
+
 /***************************************************************************/
 void TwoPassMngr::EmptyLog()
 {
@@ -161,16 +208,15 @@ void TwoPassMngr::EmptyLog()
   {
     inputFile.getline(sLine, 256);
 
-    auto str_PicSize = strtok(sLine, " ");
-    auto str_PercentIntra = strtok(NULL, " ");
-    auto str_PercentSkip = strtok(NULL, " ");
+    char const* pCur = sLine;
+    int iPicSize, iPercentIntra, iPercentSkip;
 
-    bFind = (str_PicSize != NULL && str_PercentIntra != NULL && str_PercentSkip != NULL);
+    bFind = ScanInt(pCur, iPicSize) && ScanInt(pCur, iPercentIntra) && ScanInt(pCur, iPercentSkip);
 
     if(!bFind)
       break;
 
-    AddNewFrame(atoi(str_PicSize), atoi(str_PercentIntra), atoi(str_PercentSkip));
+    AddNewFrame(iPicSize, iPercentIntra, iPercentSkip);
     i++;
   }
 
@@ -183,9 +229,10 @@ void TwoPassMngr::FillLog()
   if(!outputFile.is_open())
     throw runtime_error("Can't open TwoPass LogFile");
 
-  for(auto frame: tFrames)
-    outputFile << frame.iPictureSize << " " << static_cast<int>(frame.iPercentIntra) << " " << static_cast<int>(frame.iPercentSkip) << endl;
+  for(auto const& frame: tFrames)
+    outputFile << frame.iPictureSize << " " << static_cast<int>(frame.iPercentIntra) << " " << static_cast<int>(frame.iPercentSkip) << "\n";
 
+  outputFile.flush();
   tFrames.clear();
 }
 
@@ -263,22 +310,17 @@ void TwoPassMngr::ComputeTwoPass()
   {
     tFrames[i].iIPRatio = GetIPRatio(&tFrames[i], &tFrames[i + 1]);
 
-    for(int k = i + 2; k < min(iSequenceSize, i + 4) && !SceneChangeDetected(&tFrames[k - 1], &tFrames[k]); k++)
+    for(int k = i + 2; k < min(iSequenceSize, i + 4) && !tFrames[k - 1].bNextSceneChange; k++)
       tFrames[i].iIPRatio = min(tFrames[i].iIPRatio, GetIPRatio(&tFrames[i], &tFrames[k]));
   }
 }
 
 /***************************************************************************/
-static int GetLocalComplexity(vector<AL_TLookAheadMetaData> tFrames, int iLocalIndex, int iIndexMax, size_t zPicSizeMoy)
+static int GetLocalComplexity(size_t zSumLocal, int iLocalIndex, int iIndexMax, size_t zPicSizeMoy)
 {
   if(iIndexMax - iLocalIndex < LOCAL_RANGE)
     return 1000;
 
-  size_t zSumLocal = 0;
-
-  for(int k = 0; k < LOCAL_RANGE; k++)
-    zSumLocal += tFrames[iLocalIndex + k].iPictureSize;
-
   return 1000 * (zSumLocal / LOCAL_RANGE) / zPicSizeMoy;
 }
 
@@ -291,18 +333,28 @@ void TwoPassMngr::ComputeComplexity()
 
   size_t zSumPicSize = 0;
 
-  for(auto frame: tFrames)
+  for(auto const& frame: tFrames)
     zSumPicSize += frame.iPictureSize;
 
   auto zPicSizeMoy = zSumPicSize / iSequenceSize;
 
+  // sum of the picture sizes of [k, k + LOCAL_RANGE), slid along the sequence
+  size_t zSumLocal = 0;
+
+  for(int k = 0; k < min(LOCAL_RANGE, iSequenceSize); k++)
+    zSumLocal += tFrames[k].iPictureSize;
+
   int iComplexity = 1000;
 
   for(int k = 0; k < iSequenceSize; k++)
   {
     if(k % LOCAL_RANGE == 0)
-      iComplexity = GetLocalComplexity(tFrames, k, iSequenceSize, zPicSizeMoy);
+      iComplexity = GetLocalComplexity(zSumLocal, k, iSequenceSize, zPicSizeMoy);
     tFrames[k].iComplexity = iComplexity;
+
+    zSumLocal -= tFrames[k].iPictureSize;
+
+    if(k + LOCAL_RANGE < iSequenceSize)
+      zSumLocal += tFrames[k + LOCAL_RANGE].iPictureSize;
   }
 }
-
@@ -60,6 +60,10 @@ bool AL_TwoPassMngr_SceneChangeDetected(AL_TBuffer* pPrevSrc, AL_TBuffer* pCurre
 *****************************************************************************/
 int32_t AL_TwoPassMngr_GetIPRatio(AL_TBuffer* pCurrentSrc, AL_TBuffer* pNextSrc);
 
+/* Same as above, on the lookahead metadata of the frames. Null metadata are accepted */
+bool AL_TwoPassMngr_SceneChangeDetected(AL_TLookAheadMetaData* pPrevMeta, AL_TLookAheadMetaData* pCurrentMeta);
+int32_t AL_TwoPassMngr_GetIPRatio(AL_TLookAheadMetaData* pCurrentMeta, AL_TLookAheadMetaData* pNextMeta);
+
 /***************************************************************************/
 /*Offline TwoPass structures and methods*/
 /***************************************************************************/
@@ -317,6 +317,7 @@ void ParseCommandLine(int argc, char** argv, ConfigFile& cfg)
   opt.addInt("--num-slices", &cfg.Settings.tChParam[0].uNumSlices, "Specifies the number of slices to use");
   opt.addInt("--num-core", &cfg.Settings.tChParam[0].uNumCore, "Specifies the number of cores to use (resolution needs to be sufficient)");
   opt.addString("--log", &cfg.RunInfo.logsFile, "A file where log event will be dumped");
+  opt.addFlag("--reactor", &cfg.RunInfo.iSchedulerType, "Dispatch the channel statuses from an event reactor instead of a thread per channel", SCHEDULER_TYPE_MCU_REACTOR);
   opt.addFlag("--loop", &cfg.RunInfo.bLoop, "Loop at the end of the yuv file");
   opt.addFlag("--slicelat", &cfg.Settings.tChParam[0].bSubframeLatency, "Enable subframe latency");
   opt.addFlag("--framelat", &cfg.Settings.tChParam[0].bSubframeLatency, "Disable subframe latency", false);
@@ -463,7 +464,7 @@ static AL_TOffsetYC GetOffsetYC(int iPitchY, int iHeight, TFourCC fourCC)
 
 /*****************************************************************************/
 static
-shared_ptr<AL_TBuffer> AllocateConversionBuffer(vector<uint8_t>& YuvBuffer, int iWidth, int iHeight, TFourCC tFourCC)
+shared_ptr<AL_TBuffer> AllocateConversionBuffer(int iWidth, int iHeight, TFourCC tFourCC)
 {
   /* we want to read from /write to a file, so no alignement is necessary */
   int const iWidthInBytes = GetIOLumaRowSize(tFourCC, static_cast<uint32_t>(iWidth));
@@ -483,15 +484,21 @@ shared_ptr<AL_TBuffer> AllocateConversionBuffer(vector<uint8_t>& YuvBuffer, int
     break;
   }
 
-  YuvBuffer.resize(uSize);
-  AL_TBuffer* Yuv = AL_Buffer_WrapData(YuvBuffer.data(), uSize, NULL);
+  /* whole frames are walked by the conversion loops: keep them on hugepages */
+  AL_TBuffer* Yuv = AL_Buffer_Create_And_Allocate(AL_GetHugePageAllocator(), uSize, NULL);
+
+  if(!Yuv)
+    throw runtime_error("Couldn't allocate conversion buffer");
 
   AL_TOffsetYC tOffsetYC = GetOffsetYC(tPitches.iLuma, iHeight, tFourCC);
   AL_TDimension tDimension = { iWidth, iHeight };
   AL_TMetaData* pMeta = (AL_TMetaData*)AL_SrcMetaData_Create(tDimension, tPitches, tOffsetYC, tFourCC);
 
   if(!pMeta)
+  {
+    AL_Buffer_Destroy(Yuv);
     throw runtime_error("Couldn't allocate conversion buffer");
+  }
   AL_Buffer_AddMetaData(Yuv, pMeta);
 
   return shared_ptr<AL_TBuffer>(Yuv, &AL_Buffer_Destroy);
@@ -511,14 +518,14 @@ shared_ptr<AL_TBuffer> ReadSourceFrame(BufPool* pBufPool, AL_TBuffer* conversion
   return sourceBuffer;
 }
 
-bool ConvertSrcBuffer(AL_TEncChanParam& tChParam, TYUVFileInfo& FileInfo, vector<uint8_t>& YuvBuffer, shared_ptr<AL_TBuffer>& SrcYuv)
+bool ConvertSrcBuffer(AL_TEncChanParam& tChParam, TYUVFileInfo& FileInfo, shared_ptr<AL_TBuffer>& SrcYuv)
 {
   auto const picFmt = AL_EncGetSrcPicFormat(AL_GET_CHROMA_MODE(tChParam.ePicFormat), tChParam.uSrcBitDepth, AL_GetSrcStorageMode(tChParam.eSrcMode),
                                             AL_IsSrcCompressed(tChParam.eSrcMode));
   bool shouldConvert = IsConversionNeeded(FileInfo.FourCC, picFmt);
 
   if(shouldConvert)
-    SrcYuv = AllocateConversionBuffer(YuvBuffer, FileInfo.PictWidth, FileInfo.PictHeight, FileInfo.FourCC);
+    SrcYuv = AllocateConversionBuffer(FileInfo.PictWidth, FileInfo.PictHeight, FileInfo.FourCC);
   return shouldConvert;
 }
 
@@ -788,16 +795,14 @@ void SafeMain(int argc, char** argv)
 
   // Input/Output Format conversion
   shared_ptr<AL_TBuffer> SrcYuv;
-  vector<uint8_t> YuvBuffer;
-  bool shouldConvert = ConvertSrcBuffer(Settings.tChParam[0], FileInfo, YuvBuffer, SrcYuv);
+  bool shouldConvert = ConvertSrcBuffer(Settings.tChParam[0], FileInfo, SrcYuv);
 
 
   shared_ptr<AL_TBuffer> RecYuv;
-  vector<uint8_t> RecYuvBuffer;
 
   if(!RecFileName.empty())
   {
-    RecYuv = AllocateConversionBuffer(RecYuvBuffer, Settings.tChParam[0].uWidth, Settings.tChParam[0].uHeight, cfg.RecFourCC);
+    RecYuv = AllocateConversionBuffer(Settings.tChParam[0].uWidth, Settings.tChParam[0].uHeight, cfg.RecFourCC);
     enc->RecOutput = createFrameWriter(RecFileName, cfg, RecYuv.get(), 0);
   }
 
@@ -811,6 +816,11 @@ void SafeMain(int argc, char** argv)
   }
 
 
+  vector<AL_TBuffer*> streams;
+#if AL_ENABLE_TWOPASS
+  vector<AL_TBuffer*> lookAheadStreams;
+#endif
+
   for(unsigned int i = 0; i < StreamBufPoolConfig.uNumBuf; ++i)
   {
     AL_TBuffer* pStream = StreamBufPool.GetBuffer(AL_BUF_MODE_NONBLOCK);
@@ -824,17 +834,36 @@ void SafeMain(int argc, char** argv)
       assert(attached);
     }
 
-    AL_HEncoder hEnc = enc->hEnc;
-
 #if AL_ENABLE_TWOPASS
 
     // the Lookahead needs one stream buffer to work (2 in AVC multi-core)
     if(AL_TwoPassMngr_HasLookAhead(cfg.Settings) && i < ((Settings.tChParam[0].eProfile & AL_PROFILE_AVC) ? 2 : 1))
-      hEnc = encFirstPassLA->hEnc;
+    {
+      lookAheadStreams.push_back(pStream);
+      continue;
+    }
+#endif
+    streams.push_back(pStream);
+  }
+
+#if AL_ENABLE_TWOPASS
+
+  if(!lookAheadStreams.empty())
+  {
+    bool bRet = AL_Encoder_PutStreamBuffers(encFirstPassLA->hEnc, lookAheadStreams.data(), lookAheadStreams.size());
+    assert(bRet);
+
+    for(auto pStream : lookAheadStreams)
+      AL_Buffer_Unref(pStream);
+  }
 #endif
-    bool bRet = AL_Encoder_PutStreamBuffer(hEnc, pStream);
+
+  {
+    bool bRet = AL_Encoder_PutStreamBuffers(enc->hEnc, streams.data(), streams.size());
     assert(bRet);
-    AL_Buffer_Unref(pStream);
+
+    for(auto pStream : streams)
+      AL_Buffer_Unref(pStream);
   }
 
 
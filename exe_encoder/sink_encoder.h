@@ -53,13 +53,13 @@
 #include <fstream>
 #include <stdexcept>
 
-static bool PreprocessQP(uint8_t* pQPs, const AL_TEncSettings& Settings, const AL_TEncChanParam& tChParam, const std::string& sQPTablesFolder, int iFrameCountSent)
+static bool PreprocessQP(uint8_t* pQPs, const AL_TEncSettings& Settings, const AL_TEncChanParam& tChParam, const std::string& sQPTablesFolder, QPTablesPrefetcher* pQPTables, int iFrameCountSent)
 {
   uint8_t* pSegs = NULL;
   return GenerateQPBuffer(Settings.eQpCtrlMode, tChParam.tRCParam.iInitialQP,
                           tChParam.tRCParam.iMinQP, tChParam.tRCParam.iMaxQP,
                           AL_GetWidthInLCU(tChParam), AL_GetHeightInLCU(tChParam),
-                          tChParam.eProfile, sQPTablesFolder, iFrameCountSent, pQPs + EP2_BUF_QP_BY_MB.Offset, pSegs);
+                          tChParam.eProfile, sQPTablesFolder, iFrameCountSent, pQPs + EP2_BUF_QP_BY_MB.Offset, pSegs, pQPTables);
 }
 
 class QPBuffers
@@ -93,13 +93,14 @@ public:
 
   void setRoiFileName(std::string const& roiFileName)
   {
-    sRoiFileName = roiFileName;
+    roiFile.Load(roiFileName);
   }
 
 
   void setQPTablesFolder(std::string const& sQPTablesFolder)
   {
     this->sQPTablesFolder = sQPTablesFolder;
+    qpTables.SetFolder(sQPTablesFolder);
   }
 
 private:
@@ -124,10 +125,10 @@ private:
       return nullptr;
 
     AL_TBuffer* pQpBuf = pBufPool->GetBuffer();
-    bool bRet = PreprocessQP(AL_Buffer_GetData(pQpBuf), settings, tChParam, sQPTablesFolder, frameNum);
+    bool bRet = PreprocessQP(AL_Buffer_GetData(pQpBuf), settings, tChParam, sQPTablesFolder, &qpTables, frameNum);
 
     if(!bRet)
-      bRet = GenerateROIBuffer(pRoiCtx, sRoiFileName, AL_GetWidthInLCU(tChParam), AL_GetHeightInLCU(tChParam),
+      bRet = GenerateROIBuffer(pRoiCtx, roiFile, AL_GetWidthInLCU(tChParam), AL_GetHeightInLCU(tChParam),
                                tChParam.eProfile, frameNum, AL_Buffer_GetData(pQpBuf) + EP2_BUF_QP_BY_MB.Offset);
 
     if(!bRet)
@@ -145,7 +146,8 @@ private:
   const AL_TEncSettings& settings;
   std::string sQPTablesFolder;
 
-  std::string sRoiFileName;
+  RoiFileIndex roiFile;
+  QPTablesPrefetcher qpTables;
   AL_TRoiMngrCtx* pRoiCtx;
 };
 
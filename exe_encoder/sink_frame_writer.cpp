@@ -39,12 +39,18 @@
 #include "CodecUtils.h"
 #include "lib_app/utils.h"
 #include <cassert>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 extern "C"
 {
 #include "lib_encode/lib_encoder.h"
 #include "lib_common/BufferSrcMeta.h"
+#include "lib_common/Allocator.h"
 #include "lib_common_enc/IpEncFourCC.h"
 }
 #include "lib_app/convert.h"
@@ -184,35 +190,146 @@ void RecToYuv(AL_TBuffer const* pRec, AL_TBuffer* pYuv, TFourCC tFourCC)
 
 using namespace std;
 
+/****************************************************************************/
+static AL_TBuffer* CreateBufferLike(AL_TBuffer const* pModel, size_t zSize)
+{
+  AL_TBuffer* pBuf = AL_Buffer_Create_And_Allocate(AL_GetHugePageAllocator(), zSize, NULL);
+
+  if(!pBuf)
+    throw runtime_error("Couldn't allocate reconstructed frame buffer");
+
+  auto pMeta = (AL_TSrcMetaData*)AL_Buffer_GetMetaData(pModel, AL_META_TYPE_SOURCE);
+  AL_Buffer_AddMetaData(pBuf, (AL_TMetaData*)AL_SrcMetaData_Clone(pMeta));
+  return pBuf;
+}
+
+/*
+** The reconstructed frames are copied as is in a few staging buffers, so that the encoder gets them back right away.
+** The conversion to the output format and the file write are done by a worker thread.
+** When all the staging buffers are in flight, the encoder output path waits for the worker to catch up.
+*/
 class FrameWriter : public IFrameSink
 {
 public:
-  FrameWriter(string RecFileName, ConfigFile& cfg_, AL_TBuffer* Yuv_, int iLayerID) : m_cfg(cfg_), m_Yuv(Yuv_), m_iLayerID(iLayerID)
+  FrameWriter(string RecFileName, ConfigFile& cfg_, AL_TBuffer* Yuv_, int iLayerID) : m_cfg(cfg_), m_iLayerID(iLayerID)
   {
     OpenOutput(m_RecFile, RecFileName);
+    m_pYuv = CreateBufferLike(Yuv_, Yuv_->zSize);
+    m_Worker = thread(&FrameWriter::Write, this);
+  }
+
+  ~FrameWriter()
+  {
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      m_bExit = true;
+    }
+    m_Cv.notify_all();
+    m_Worker.join();
+
+    for(auto pBuf : m_FreeRecs)
+      AL_Buffer_Destroy(pBuf);
+
+    AL_Buffer_Destroy(m_pYuv);
   }
 
   void ProcessFrame(AL_TBuffer* pBuf)
   {
     if(pBuf == EndOfStream)
     {
+      unique_lock<mutex> lock(m_Mutex);
+      m_Cv.wait(lock, [&] { return m_PendingRecs.empty() && !m_bWriting; });
       m_RecFile.flush();
       return;
     }
 
-    auto& tChParam = m_cfg.Settings.tChParam[m_iLayerID];
+    AL_TBuffer* pRec = GetFreeRec(pBuf);
+    Rtos_Memcpy(AL_Buffer_GetData(pRec), AL_Buffer_GetData(pBuf), pBuf->zSize);
+
     {
-      RecToYuv(pBuf, m_Yuv, m_cfg.RecFourCC);
-      WriteOneFrame(m_RecFile, m_Yuv, tChParam.uWidth, tChParam.uHeight);
+      lock_guard<mutex> lock(m_Mutex);
+      m_PendingRecs.push_back(pRec);
     }
+    m_Cv.notify_all();
   }
 
-
 private:
+  static const size_t NUM_REC_BUFFERS = 3;
+
+  AL_TBuffer* GetFreeRec(AL_TBuffer* pModel)
+  {
+    AL_TBuffer* pRec = nullptr;
+    {
+      unique_lock<mutex> lock(m_Mutex);
+      m_Cv.wait(lock, [&] { return !m_FreeRecs.empty() || m_zNumRecs < NUM_REC_BUFFERS; });
+
+      if(!m_FreeRecs.empty())
+      {
+        pRec = m_FreeRecs.back();
+        m_FreeRecs.pop_back();
+      }
+      else
+        ++m_zNumRecs;
+    }
+
+    if(pRec && pRec->zSize < pModel->zSize)
+    {
+      AL_Buffer_Destroy(pRec);
+      pRec = nullptr;
+    }
+
+    if(!pRec)
+      return CreateBufferLike(pModel, pModel->zSize);
+
+    auto pRecMeta = (AL_TSrcMetaData*)AL_Buffer_GetMetaData(pRec, AL_META_TYPE_SOURCE);
+    auto pModelMeta = (AL_TSrcMetaData*)AL_Buffer_GetMetaData(pModel, AL_META_TYPE_SOURCE);
+    pRecMeta->tDim = pModelMeta->tDim;
+    pRecMeta->tPitches = pModelMeta->tPitches;
+    pRecMeta->tOffsetYC = pModelMeta->tOffsetYC;
+    pRecMeta->tFourCC = pModelMeta->tFourCC;
+    return pRec;
+  }
+
+  void Write()
+  {
+    auto& tChParam = m_cfg.Settings.tChParam[m_iLayerID];
+    unique_lock<mutex> lock(m_Mutex);
+
+    while(true)
+    {
+      m_Cv.wait(lock, [&] { return m_bExit || !m_PendingRecs.empty(); });
+
+      if(m_PendingRecs.empty())
+        return;
+
+      AL_TBuffer* pRec = m_PendingRecs.front();
+      m_PendingRecs.pop_front();
+      m_bWriting = true;
+
+      lock.unlock();
+      RecToYuv(pRec, m_pYuv, m_cfg.RecFourCC);
+      WriteOneFrame(m_RecFile, m_pYuv, tChParam.uWidth, tChParam.uHeight);
+      lock.lock();
+
+      m_bWriting = false;
+      m_FreeRecs.push_back(pRec);
+      m_Cv.notify_all();
+    }
+  }
+
   ofstream m_RecFile;
   ConfigFile& m_cfg;
-  AL_TBuffer* const m_Yuv;
+  AL_TBuffer* m_pYuv;
   int m_iLayerID;
+
+  mutex m_Mutex;
+  condition_variable m_Cv;
+  deque<AL_TBuffer*> m_PendingRecs;
+  vector<AL_TBuffer*> m_FreeRecs;
+  size_t m_zNumRecs = 0;
+  bool m_bWriting = false;
+  bool m_bExit = false;
+  thread m_Worker;
 };
 
 unique_ptr<IFrameSink> createFrameWriter(string path, ConfigFile& cfg_, AL_TBuffer* Yuv_, int iLayerID_)
@@ -41,9 +41,75 @@
 #include "sink_encoder.h"
 
 #include <memory>
-#include <deque>
+#include <vector>
 #include <stdexcept>
 
+/*
+** Fixed capacity ring of the frames waiting for their second pass
+** The lookahead metadata of each frame is looked up once, when it enters the ring,
+** and the sum of the picture sizes is kept up to date so that the window never has to be walked
+*/
+class LookAheadFifo
+{
+public:
+  struct TEntry
+  {
+    AL_TBuffer* pSrc;
+    AL_TLookAheadMetaData* pMeta;
+  };
+
+  explicit LookAheadFifo(int iCapacity) : entries(iCapacity)
+  {
+  }
+
+  int size() const
+  {
+    return iSize;
+  }
+
+  void push_back(AL_TBuffer* pSrc)
+  {
+    assert(iSize < static_cast<int>(entries.size()));
+    auto& entry = entries[(iHead + iSize) % entries.size()];
+    entry.pSrc = pSrc;
+    entry.pMeta = (AL_TLookAheadMetaData*)AL_Buffer_GetMetaData(pSrc, AL_META_TYPE_LOOKAHEAD);
+    iSumPictureSize += PictureSize(entry);
+    ++iSize;
+  }
+
+  TEntry pop_front()
+  {
+    assert(iSize > 0);
+    auto entry = entries[iHead];
+    iSumPictureSize -= PictureSize(entry);
+    iHead = (iHead + 1) % entries.size();
+    --iSize;
+    return entry;
+  }
+
+  TEntry const& operator[](int i) const
+  {
+    assert(i < iSize);
+    return entries[(iHead + i) % entries.size()];
+  }
+
+  intmax_t sumPictureSize() const
+  {
+    return iSumPictureSize;
+  }
+
+  static intmax_t PictureSize(TEntry const& entry)
+  {
+    return entry.pMeta ? entry.pMeta->iPictureSize : 0;
+  }
+
+private:
+  std::vector<TEntry> entries;
+  int iHead = 0;
+  int iSize = 0;
+  intmax_t iSumPictureSize = 0;
+};
+
 /*
 ** Special EncoderSink structure, used for encoding the first pass
 ** The encoding settings are adapted for the first pass
@@ -58,7 +124,8 @@ struct EncoderLookAheadSink : IFrameSink
                        ) :
     CmdFile(cfg.sCmdFileName),
     EncCmd(CmdFile, cfg.RunInfo.iScnChgLookAhead, cfg.Settings.tChParam[0].tGopParam.uFreqLT),
-    qpBuffers(qpBufPool, cfg.Settings, cfg.Settings.tChParam[0])
+    qpBuffers(qpBufPool, cfg.Settings, cfg.Settings.tChParam[0]),
+    m_fifo(cfg.Settings.LookAhead)
   {
     qpBuffers.setRoiFileName(cfg.sRoiFileName);
 
@@ -138,7 +205,7 @@ private:
   CEncCmdMngr EncCmd;
   QPBuffers qpBuffers;
   std::unique_ptr<CommandsSender> commandsSender;
-  std::deque<AL_TBuffer*> m_fifo;
+  LookAheadFifo m_fifo;
   bool bEndOfStream;
   uint16_t uLookAheadSize;
   bool bUseComplexity;
@@ -220,10 +287,10 @@ private:
     // Fifo is full, or fifo must be emptied at EOS
     else if(bEndOfStream || m_fifo.size() == uLookAheadSize)
     {
-      AL_TBuffer* pSrc = m_fifo.front();
-      m_fifo.pop_front();
+      auto entry = m_fifo.pop_front();
+      AL_TBuffer* pSrc = entry.pSrc;
 
-      ProcessLookAheadParams(pSrc);
+      ProcessLookAheadParams(entry.pMeta);
 
       next->ProcessFrame(pSrc);
       AL_Buffer_Unref(pSrc);
@@ -234,10 +301,9 @@ private:
     }
   }
 
-  void ProcessLookAheadParams(AL_TBuffer* pSrc)
+  void ProcessLookAheadParams(AL_TLookAheadMetaData* pPictureMetaLA)
   {
-    auto pPictureMetaLA = (AL_TLookAheadMetaData*)AL_Buffer_GetMetaData(pSrc, AL_META_TYPE_LOOKAHEAD);
-    int iFifoSize = static_cast<int>(m_fifo.size());
+    int iFifoSize = m_fifo.size();
 
     if(pPictureMetaLA)
     {
@@ -246,11 +312,11 @@ private:
 
       if(iFifoSize >= 1)
       {
-        pPictureMetaLA->bNextSceneChange = AL_TwoPassMngr_SceneChangeDetected(pSrc, m_fifo[0]);
-        pPictureMetaLA->iIPRatio = AL_TwoPassMngr_GetIPRatio(pSrc, m_fifo[0]);
+        pPictureMetaLA->bNextSceneChange = AL_TwoPassMngr_SceneChangeDetected(pPictureMetaLA, m_fifo[0].pMeta);
+        pPictureMetaLA->iIPRatio = AL_TwoPassMngr_GetIPRatio(pPictureMetaLA, m_fifo[0].pMeta);
 
-        for(int i = 1; i < Min(iFifoSize, 3) && !AL_TwoPassMngr_SceneChangeDetected(m_fifo[i - 1], m_fifo[i]); i++)
-          pPictureMetaLA->iIPRatio = Min(pPictureMetaLA->iIPRatio, AL_TwoPassMngr_GetIPRatio(pSrc, m_fifo[i]));
+        for(int i = 1; i < Min(iFifoSize, 3) && !AL_TwoPassMngr_SceneChangeDetected(m_fifo[i - 1].pMeta, m_fifo[i].pMeta); i++)
+          pPictureMetaLA->iIPRatio = Min(pPictureMetaLA->iIPRatio, AL_TwoPassMngr_GetIPRatio(pPictureMetaLA, m_fifo[i].pMeta));
       }
     }
   }
@@ -258,22 +324,22 @@ private:
   void ComputeComplexity()
   {
     iComplexityCount++;
-    int iFifoSize = static_cast<int>(m_fifo.size());
+    int iFifoSize = m_fifo.size();
 
     if(iComplexityCount >= 5 && (bEndOfStream || iFifoSize == uLookAheadSize))
     {
       iComplexityCount = 0;
       iComplexity = 1000;
 
-      if(iFifoSize >= 5 && AL_Buffer_GetMetaData(m_fifo.front(), AL_META_TYPE_LOOKAHEAD))
+      if(iFifoSize >= 5 && m_fifo[0].pMeta)
       {
+        // only the first 5 frames are summed, the whole window sum is maintained by the fifo
         intmax_t iComp[2] = { 0, 0 };
 
-        for(int i = 0; i < iFifoSize; i++)
-        {
-          auto pPictureMetaLA = (AL_TLookAheadMetaData*)AL_Buffer_GetMetaData(m_fifo[i], AL_META_TYPE_LOOKAHEAD);
-          iComp[(i < 5) ? 0 : 1] += pPictureMetaLA->iPictureSize;
-        }
+        for(int i = 0; i < 5; i++)
+          iComp[0] += LookAheadFifo::PictureSize(m_fifo[i]);
+
+        iComp[1] = m_fifo.sumPictureSize() - iComp[0];
 
         iComplexity = ((1000 * iFifoSize / 5) + iComplexityDiff) * iComp[0] / (iComp[0] + iComp[1]);
         iComplexity = Min(3000, Max(100, iComplexity));
@@ -36,6 +36,11 @@
 ******************************************************************************/
 
 #include <fstream>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "lib_app/utils.h"
 #include "sink_md5.h"
 #include "MD5.h"
@@ -48,6 +53,11 @@ extern "C"
 
 void RecToYuv(AL_TBuffer const* pRec, AL_TBuffer* pYuv, TFourCC tFourCC);
 
+/*
+** The frames are hashed on a worker thread so that the encoder callback only pays for a copy.
+** A few staging buffers are recycled between the two threads; when all of them are in flight,
+** the callback waits for the worker to catch up.
+*/
 class Md5Calculator : public IFrameSink
 {
 public:
@@ -56,12 +66,27 @@ public:
     fourcc(cfg_.RecFourCC)
   {
     OpenOutput(m_Md5File, path);
+    m_StagingBuffers.resize(NUM_STAGING_BUFFERS);
+    m_Worker = std::thread(&Md5Calculator::Hash, this);
+  }
+
+  ~Md5Calculator()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_bExit = true;
+    }
+    m_Cv.notify_all();
+    m_Worker.join();
   }
 
   void ProcessFrame(AL_TBuffer* pBuf)
   {
     if(pBuf == EndOfStream)
     {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Cv.wait(lock, [&] { return m_PendingBuffers.empty() && !m_bHashing; });
+
       auto const sMD5 = m_MD5.GetMD5();
       m_Md5File << sMD5;
       return;
@@ -75,15 +100,64 @@ public:
       pBuf = Yuv;
     }
 
-    m_MD5.Update(AL_Buffer_GetData(pBuf), pBuf->zSize);
-  }
+    std::vector<uint8_t> staging;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Cv.wait(lock, [&] { return !m_StagingBuffers.empty(); });
+      staging.swap(m_StagingBuffers.back());
+      m_StagingBuffers.pop_back();
+    }
+
+    auto pData = AL_Buffer_GetData(pBuf);
+    staging.assign(pData, pData + pBuf->zSize);
 
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_PendingBuffers.push_back(std::move(staging));
+    }
+    m_Cv.notify_all();
+  }
 
 private:
+  static const int NUM_STAGING_BUFFERS = 3;
+
+  void Hash()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while(true)
+    {
+      m_Cv.wait(lock, [&] { return m_bExit || !m_PendingBuffers.empty(); });
+
+      if(m_PendingBuffers.empty())
+        return;
+
+      auto frame = std::move(m_PendingBuffers.front());
+      m_PendingBuffers.pop_front();
+      m_bHashing = true;
+
+      lock.unlock();
+      m_MD5.Update(frame.data(), frame.size());
+      lock.lock();
+
+      m_bHashing = false;
+      m_StagingBuffers.push_back(std::move(frame));
+      m_Cv.notify_all();
+    }
+  }
+
   std::ofstream m_Md5File;
   CMD5 m_MD5;
   AL_TBuffer* const Yuv;
   TFourCC const fourcc;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Cv;
+  std::deque<std::vector<uint8_t>> m_PendingBuffers;
+  std::vector<std::vector<uint8_t>> m_StagingBuffers;
+  bool m_bHashing = false;
+  bool m_bExit = false;
+  std::thread m_Worker;
 };
 
 std::unique_ptr<IFrameSink> createMd5Calculator(std::string path, ConfigFile& cfg_, AL_TBuffer* Yuv_)
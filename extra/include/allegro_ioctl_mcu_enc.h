@@ -53,6 +53,11 @@
 #define AL_MCU_GET_REC_PICTURE _IOWR('q', 23, struct al5_reconstructed_info)
 #define AL_MCU_RELEASE_REC_PICTURE _IOWR('q', 24, __u32)
 
+/* queue several stream buffers at once. All or none of them are queued.
+ * Drivers without it reject the request, userspace then falls back
+ * to one AL_MCU_PUT_STREAM_BUFFER per buffer */
+#define AL_MCU_PUT_STREAM_BUFFERS _IOWR('q', 25, struct al5_buffers)
+
 struct al5_reconstructed_info
 {
 	__u32 fd;
@@ -101,4 +106,10 @@ struct al5_buffer {
 	__u32 size;
 };
 
+struct al5_buffers {
+	__u64 buffers; /* userspace pointer on an array of struct al5_buffer */
+	__u32 num_buffers;
+	__u32 reserved; /* keeps the same size on 32 and 64-bit builds, must be 0 */
+};
+
 #endif	/* _AL_ENC_IOCTL_H_ */
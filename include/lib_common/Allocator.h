@@ -177,6 +177,40 @@ AL_TAllocator* AL_GetDefaultAllocator();
 ******************************************************************************/
 AL_TAllocator* AL_GetWrapperAllocator();
 
+/**************************************************************************//*!
+   \brief Create an arena allocator
+   This allocator doesn't support dma (GetPhysicalAddr is not supported).
+   Buffers are carved out of chunks of zChunkSize bytes obtained with Rtos_Malloc.
+   AL_Allocator_Free doesn't give any memory back: everything is released at once
+   when the arena is destroyed with AL_Allocator_Destroy. It is meant for the
+   control structures sharing the lifetime of a channel.
+   \param[in] zChunkSize size of the chunks memory is carved from. Bigger
+   allocations get a chunk of their own.
+   \return the arena allocator or NULL if the allocation fails.
+******************************************************************************/
+AL_TAllocator* AL_ArenaAllocator_Create(size_t zChunkSize);
+
+/**************************************************************************//*!
+   \brief Get the hugepage implementation of the allocator
+   This allocator doesn't support dma (GetPhysicalAddr is not supported).
+   Buffers of 1MB and more are mapped on 2MB hugepages (MAP_HUGETLB, or
+   transparent hugepages when the hugetlb pool is empty), smaller ones come
+   from Rtos_Malloc. It is meant for the frame sized host buffers the
+   conversion and copy loops walk through. Falls back to Rtos_Malloc on
+   systems without hugepages.
+******************************************************************************/
+AL_TAllocator* AL_GetHugePageAllocator();
+
+/**************************************************************************//*!
+   \brief Create a hugepage allocator binding its memory to a NUMA node
+   Same as AL_GetHugePageAllocator, with the hugepage mappings bound to
+   iNumaNode. The binding is best effort: memory stays usable if the node
+   doesn't exist.
+   \param[in] iNumaNode NUMA node the memory is bound to, -1 for no binding
+   \return the hugepage allocator or NULL if the allocation fails.
+******************************************************************************/
+AL_TAllocator* AL_HugePageAllocator_Create(int iNumaNode);
+
 typedef void (* PFN_WrapDestructor)(void* pUserData, uint8_t* pData);
 /**************************************************************************//*!
    \brief Create a handle for an already allocated data.
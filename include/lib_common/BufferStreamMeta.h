@@ -80,6 +80,17 @@ AL_TStreamMetaData* AL_StreamMetaData_Clone(AL_TStreamMetaData* pMeta);
 *****************************************************************************/
 int AL_StreamMetaData_AddSection(AL_TStreamMetaData* pMetaData, uint32_t uOffset, uint32_t uLength, uint32_t uFlags);
 
+/*************************************************************************//*!
+   \brief Append several sections at once. The new sections are contiguous and
+   are left for the caller to fill, which avoids going through
+   AL_StreamMetaData_AddSection for each of them.
+   \param[in] pMetaData Pointer to the stream metadata
+   \param[in] uNumSections number of sections to append
+   \return return a pointer to the first appended section, NULL if there isn't
+   enough room left for uNumSections sections (nothing is appended then)
+*****************************************************************************/
+AL_TStreamSection* AL_StreamMetaData_AppendSections(AL_TStreamMetaData* pMetaData, uint16_t uNumSections);
+
 /*************************************************************************//*!
    \brief Change the information of a previously added section
    \param[in] pMetaData Pointer to the stream metadata
@@ -0,0 +1,93 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#pragma once
+
+#include "lib_rtos/types.h"
+
+/*************************************************************************//*!
+   \brief Dispatches the readiness of many driver file descriptors from a small
+   pool of event threads instead of one blocking thread per channel.
+*****************************************************************************/
+typedef struct AL_t_EventReactor AL_TEventReactor;
+typedef struct AL_t_EventSource AL_TEventSource;
+
+/*************************************************************************//*!
+   \brief Called from an event thread when the file descriptor of a source is
+   ready to be read. The callback shouldn't block for long as it delays the
+   other sources handled by the same thread.
+   \param[in] pUserParam user parameter given at registration
+   \return false if the source shouldn't be watched anymore. The source still
+   has to be removed with AL_EventReactor_Remove
+*****************************************************************************/
+typedef bool (* AL_FCN_OnEvent)(void* pUserParam);
+
+/*************************************************************************//*!
+   \brief Create a reactor and start its event threads
+   \param[in] iNumThreads number of event threads. Sources are spread on the
+   least loaded thread
+   \return return the reactor, NULL if it couldn't be created (or if the
+   platform doesn't support it)
+*****************************************************************************/
+AL_TEventReactor* AL_EventReactor_Create(int iNumThreads);
+
+/*************************************************************************//*!
+   \brief Stop the event threads and destroy the reactor. All the sources
+   should have been removed beforehand.
+   \param[in] pReactor the reactor
+*****************************************************************************/
+void AL_EventReactor_Destroy(AL_TEventReactor* pReactor);
+
+/*************************************************************************//*!
+   \brief Watch a file descriptor
+   \param[in] pReactor the reactor
+   \param[in] fd file descriptor to watch for readability
+   \param[in] pfnOnEvent callback called each time fd is ready
+   \param[in] pUserParam parameter given to pfnOnEvent
+   \return return the registered source, NULL on failure
+*****************************************************************************/
+AL_TEventSource* AL_EventReactor_Add(AL_TEventReactor* pReactor, int fd, AL_FCN_OnEvent pfnOnEvent, void* pUserParam);
+
+/*************************************************************************//*!
+   \brief Stop watching a source. When this returns, the callback of the source
+   isn't running and won't be called anymore. Must not be called from a
+   callback of the same reactor.
+   \param[in] pReactor the reactor
+   \param[in] pSource source returned by AL_EventReactor_Add
+*****************************************************************************/
+void AL_EventReactor_Remove(AL_TEventReactor* pReactor, AL_TEventSource* pSource);
+
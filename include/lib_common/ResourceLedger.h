@@ -0,0 +1,111 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/**************************************************************************//*!
+   \addtogroup ResourceLedger
+
+   The resource ledger keeps track of the hardware cycle budget taken by the
+   channels running on a device, so that an application can check whether a
+   new channel can run in real time before creating it, instead of noticing
+   the oversubscription through dropped frames.
+
+   Admission is opt-in: the encoder doesn't consult the ledger by itself.
+
+   @{
+   \file
+ *****************************************************************************/
+#pragma once
+
+#include "lib_rtos/types.h"
+
+/**************************************************************************//*!
+   \brief Book-keeping of the load of the channels running on the cores of a
+   device
+******************************************************************************/
+typedef struct AL_t_ResourceLedger AL_TResourceLedger;
+
+/**************************************************************************//*!
+   \brief Result of an admission request
+******************************************************************************/
+typedef struct
+{
+  int numCores; /*!< number of cores the channel runs on */
+  uint32_t coreMask; /*!< cores the channel load is (or would be) booked on */
+  int resources; /*!< load of the channel, in 32x32 blocks per second */
+  int headroom; /*!< budget left on the device with the channel, negative when it doesn't fit */
+}AL_TAdmission;
+
+/**************************************************************************//*!
+   \brief Tells whether a channel can run in real time alongside the current
+   load, without booking it
+   \param[in] ledger the ledger of the device
+   \param[in] width width of the channel pictures
+   \param[in] height height of the channel pictures
+   \param[in] frameRate frame rate * 1000
+   \param[in] clockRatio clock ratio (1000 or 1001)
+   \param[in] numCores number of cores the channel will use, 0 to let the
+   ledger choose it
+   \param[out] admission core count, cores, load and headroom of the channel
+   \return true if the channel fits
+******************************************************************************/
+bool AL_ResourceLedger_Query(AL_TResourceLedger* ledger, int width, int height, int frameRate, int clockRatio, int numCores, AL_TAdmission* admission);
+
+/**************************************************************************//*!
+   \brief Same check as AL_ResourceLedger_Query, and books the channel load
+   on the least loaded cores when it fits
+   \return true if the channel was admitted. The load must then be given back
+   with AL_ResourceLedger_Release when the channel is destroyed
+******************************************************************************/
+bool AL_ResourceLedger_Admit(AL_TResourceLedger* ledger, int width, int height, int frameRate, int clockRatio, int numCores, AL_TAdmission* admission);
+
+/**************************************************************************//*!
+   \brief Gives back the load booked by a successful AL_ResourceLedger_Admit
+******************************************************************************/
+void AL_ResourceLedger_Release(AL_TResourceLedger* ledger, AL_TAdmission const* admission);
+
+/**************************************************************************//*!
+   \brief Returns the budget left on the device, in 32x32 blocks per second
+******************************************************************************/
+int AL_ResourceLedger_GetHeadroom(AL_TResourceLedger* ledger);
+
+/**************************************************************************//*!
+   \brief Returns the process-wide ledger of the encoder cores
+******************************************************************************/
+AL_TResourceLedger* AL_GetEncoderResourceLedger(void);
+
+/*@}*/
+
@@ -46,6 +46,7 @@
 
 #include "stdio.h"
 #include "lib_rtos/types.h"
+#include "lib_rtos/lib_rtos.h"
 #include "lib_common/SliceConsts.h"
 #include "lib_common/FourCC.h"
 #include "EncChanParam.h"
@@ -146,6 +147,7 @@ typedef AL_INTROSPECT (category = "debug") struct t_EncSettings
   uint8_t DcCoeff[8];
   uint8_t DcCoeffFlag[8];
   bool bEnableWatchdog;
+  AL_TThreadAttr tCallbackThread; /*!< Affinity, priority and stack of the thread calling the end encoding callback. Zero for the defaults. If pName is NULL, the encoder names it */
 #if AL_ENABLE_TWOPASS
   int LookAhead;
   int TwoPass;
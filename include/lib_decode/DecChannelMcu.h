@@ -0,0 +1,53 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#pragma once
+
+typedef struct AL_t_driver AL_TDriver;
+typedef struct AL_t_IDecChannel AL_TIDecChannel;
+typedef struct AL_t_EventReactor AL_TEventReactor;
+
+AL_TIDecChannel* AL_DecChannelMcu_Create(AL_TDriver* driver);
+
+/* Same as AL_DecChannelMcu_Create, but the channel statuses are dispatched by
+ * the event threads of pReactor instead of one thread per channel.
+ * The status is read from the event thread once poll() reports the channel
+ * readable: the driver mustn't report it before AL_MCU_WAIT_FOR_STATUS can
+ * return without blocking (a status is queued or the channel is destroyed).
+ * If the driver can't be polled, the channel falls back to a status thread.
+ * pReactor can be shared between decoders and must outlive their channels. */
+AL_TIDecChannel* AL_DecChannelMcu_CreateWithReactor(AL_TDriver* driver, AL_TEventReactor* pReactor);
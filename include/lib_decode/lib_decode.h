@@ -53,6 +53,7 @@
 #pragma once
 
 #include "lib_rtos/types.h"
+#include "lib_rtos/lib_rtos.h"
 
 #include "lib_common/BufferAPI.h"
 #include "lib_common/Error.h"
@@ -142,6 +143,7 @@ typedef struct
   AL_TStreamSettings tStream; /*!< Stream's settings. These need to be set if you want to preallocate the buffer. memset to 0 otherwise */
   AL_EBufferOutputMode eBufferOutputMode; /*!< Reconstructed buffers output mode */
   bool bUseIFramesAsSyncPoint; /*!< Allow decoder to sync on I frames if configurations' nals are presents */
+  AL_TThreadAttr tCallbackThread; /*!< Affinity, priority and stack of the decoder threads calling the callbacks. Zero for the defaults. If pName is NULL, the decoder names them */
 }AL_TDecSettings;
 
 /*************************************************************************//*!
@@ -41,6 +41,16 @@
 
 typedef struct AL_t_driver AL_TDriver;
 typedef struct t_Scheduler TScheduler;
+typedef struct AL_t_EventReactor AL_TEventReactor;
 
 TScheduler* AL_SchedulerMcu_Create(AL_TDriver* driver, AL_TAllocator* pDmaAllocator);
 
+/* Same as AL_SchedulerMcu_Create, but the channel statuses are dispatched by
+ * the event threads of pReactor instead of one thread per channel.
+ * The status is read from the event thread once poll() reports the channel
+ * readable: the driver mustn't report it before AL_MCU_WAIT_FOR_STATUS can
+ * return without blocking (a status is queued or the channel is destroyed).
+ * If the driver can't be polled, the channel falls back to a status thread.
+ * pReactor can be shared between schedulers and must outlive their channels. */
+TScheduler* AL_SchedulerMcu_CreateWithReactor(AL_TDriver* driver, AL_TAllocator* pDmaAllocator, AL_TEventReactor* pReactor);
+
@@ -166,6 +166,19 @@ void AL_Encoder_ReleaseRecPicture(AL_HEncoder hEnc, TRecPic* pRecPic);
 *****************************************************************************/
 bool AL_Encoder_PutStreamBuffer(AL_HEncoder hEnc, AL_TBuffer* pStream);
 
+/*************************************************************************//*!
+   \brief Pushes several stream buffers in the encoder stream buffer queue.
+   Same as calling AL_Encoder_PutStreamBuffer on each buffer, in order, but the
+   encoder context is locked only once for the whole batch.
+   \param[in] hEnc Handle to an encoder object
+   \param[in] ppStreams Array of the stream buffers given to the encoder.
+   Each of them must fulfill the AL_Encoder_PutStreamBuffer requirements
+   \param[in] iNumStreams Number of buffers in ppStreams
+   \return return true if all the buffers were successfully pushed. false if an
+   error occured
+*****************************************************************************/
+bool AL_Encoder_PutStreamBuffers(AL_HEncoder hEnc, AL_TBuffer* ppStreams[], int iNumStreams);
+
 /*************************************************************************//*!
    \brief Pushes a frame buffer to the encoder.
    According to the GOP pattern, this frame buffer could or couldn't be encoded immediately.
@@ -59,6 +59,15 @@ typedef void* AL_THREAD;
 #define AL_NO_WAIT 0
 #define AL_WAIT_FOREVER 0xFFFFFFFF
 
+/****************************************************************************/
+typedef struct
+{
+  char const* pName; /*!< name of the thread, NULL to keep the default one. Might be truncated (15 characters on Linux) */
+  uint64_t uAffinityMask; /*!< bit i set allows the thread to run on cpu i. 0 means no constraint */
+  int iPriority; /*!< real-time (SCHED_FIFO) priority. 0 keeps the default scheduling policy */
+  size_t zStackSize; /*!< stack size in bytes. 0 keeps the default one */
+}AL_TThreadAttr;
+
 /****************************************************************************/
 
 /****************************************************************************/
@@ -106,6 +115,9 @@ bool Rtos_SetEvent(AL_EVENT Event);
 /*  Threads */
 /****************************************************************************/
 AL_THREAD Rtos_CreateThread(void* (*pFunc)(void* pParam), void* pParam);
+/* Same as Rtos_CreateThread, pAttr can be NULL. If the real-time priority
+ * isn't allowed, the thread is created with the default scheduling policy */
+AL_THREAD Rtos_CreateThreadWithAttr(void* (*pFunc)(void* pParam), void* pParam, AL_TThreadAttr const* pAttr);
 bool Rtos_JoinThread(AL_THREAD Thread);
 void Rtos_DeleteThread(AL_THREAD Thread);
 
@@ -45,17 +45,63 @@ extern "C"
 
 #include "BufPool.h"
 
-static bool Fifo_Init(App_Fifo* pFifo, size_t zMaxElem);
-static void Fifo_Deinit(App_Fifo* pFifo);
-static bool Fifo_Queue(App_Fifo* pFifo, void* pElem, uint32_t uWait);
-static void* Fifo_Dequeue(App_Fifo* pFifo, uint32_t uWait);
-static void Fifo_Decommit(App_Fifo* pFifo);
+/*
+** The free buffers are kept in a lock-free stack (Treiber stack) threaded
+** through pSlots. The head packs the index + 1 of the top buffer with a tag
+** incremented on every update, so that a pop racing with a pop/push of the
+** same buffer (ABA) fails its CAS. Getters only sleep when the stack is empty.
+*/
+#define FREE_HEAD(uIndexPlusOne, uTag) (((uint64_t)(uTag) << 32) | (uIndexPlusOne))
+#define FREE_HEAD_INDEX(uHead) ((uint32_t)(uHead))
+#define FREE_HEAD_TAG(uHead) ((uint32_t)((uHead) >> 32))
+
+/****************************************************************************/
+static void PushFree(AL_TBufPool* pBufPool, uint32_t uIndex)
+{
+  AL_TBufPoolSlot* pSlot = &pBufPool->pSlots[uIndex];
+  uint64_t uHead = __atomic_load_n(&pBufPool->uFreeHead, __ATOMIC_RELAXED);
+  uint64_t uNewHead;
+
+  do
+  {
+    __atomic_store_n(&pSlot->uNext, FREE_HEAD_INDEX(uHead), __ATOMIC_RELAXED);
+    uNewHead = FREE_HEAD(uIndex + 1, FREE_HEAD_TAG(uHead) + 1);
+  }
+  while(!__atomic_compare_exchange_n(&pBufPool->uFreeHead, &uHead, uNewHead, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+}
+
+/****************************************************************************/
+static AL_TBuffer* PopFree(AL_TBufPool* pBufPool)
+{
+  uint64_t uHead = __atomic_load_n(&pBufPool->uFreeHead, __ATOMIC_ACQUIRE);
+  uint64_t uNewHead;
+
+  do
+  {
+    if(FREE_HEAD_INDEX(uHead) == 0)
+      return NULL;
+
+    /* may be stale if another thread popped the buffer meanwhile: the tag
+     * makes the CAS fail in that case */
+    uint32_t uNext = __atomic_load_n(&pBufPool->pSlots[FREE_HEAD_INDEX(uHead) - 1].uNext, __ATOMIC_RELAXED);
+    uNewHead = FREE_HEAD(uNext, FREE_HEAD_TAG(uHead) + 1);
+  }
+  while(!__atomic_compare_exchange_n(&pBufPool->uFreeHead, &uHead, uNewHead, true, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE));
+
+  return pBufPool->pPool[FREE_HEAD_INDEX(uHead) - 1];
+}
 
 /****************************************************************************/
 static void FreeBufInPool(AL_TBuffer* pBuf)
 {
-  auto pBufPool = (AL_TBufPool*)AL_Buffer_GetUserData(pBuf);
-  Fifo_Queue(&pBufPool->fifo, pBuf, AL_WAIT_FOREVER);
+  auto pSlot = (AL_TBufPoolSlot*)AL_Buffer_GetUserData(pBuf);
+  auto pBufPool = pSlot->pBufPool;
+  PushFree(pBufPool, (uint32_t)(pSlot - pBufPool->pSlots));
+
+  /* pairs with the waiter registration in AL_BufPool_GetBuffer: either the
+   * waiter sees the buffer, or we see the waiter */
+  if(__atomic_load_n(&pBufPool->iNumWaiters, __ATOMIC_SEQ_CST) > 0)
+    Rtos_ReleaseSemaphore(pBufPool->hFreeSem);
 }
 
 static AL_TBuffer* CreateBuffer(AL_TBufPoolConfig& config, AL_TAllocator* pAllocator)
@@ -96,9 +142,11 @@ static bool AL_sBufPool_AllocBuf(AL_TBufPool* pBufPool)
 
   if(!pBuf)
     return false;
-  AL_Buffer_SetUserData(pBuf, pBufPool);
-  pBufPool->pPool[pBufPool->uNumBuf++] = pBuf;
-  Fifo_Queue(&pBufPool->fifo, pBuf, AL_WAIT_FOREVER);
+  uint32_t uIndex = pBufPool->uNumBuf++;
+  pBufPool->pSlots[uIndex].pBufPool = pBufPool;
+  AL_Buffer_SetUserData(pBuf, &pBufPool->pSlots[uIndex]);
+  pBufPool->pPool[uIndex] = pBuf;
+  PushFree(pBufPool, uIndex);
   return true;
 }
 
@@ -113,8 +161,12 @@ bool AL_BufPool_Init(AL_TBufPool* pBufPool, AL_TAllocator* pAllocator, AL_TBufPo
     return false;
 
   pBufPool->pAllocator = pAllocator;
+  pBufPool->uFreeHead = FREE_HEAD(0, 0);
+  pBufPool->iNumWaiters = 0;
+  pBufPool->bDecommitted = false;
+  pBufPool->hFreeSem = Rtos_CreateSemaphore(0);
 
-  if(!Fifo_Init(&pBufPool->fifo, pConfig->uNumBuf))
+  if(!pBufPool->hFreeSem)
     goto fail_init;
 
   pBufPool->config = *pConfig;
@@ -123,8 +175,9 @@ bool AL_BufPool_Init(AL_TBufPool* pBufPool, AL_TAllocator* pAllocator, AL_TBufPo
   zMemPoolSize = pConfig->uNumBuf * sizeof(AL_TBuffer*);
 
   pBufPool->pPool = (AL_TBuffer**)Rtos_Malloc(zMemPoolSize);
+  pBufPool->pSlots = (AL_TBufPoolSlot*)Rtos_Malloc(pConfig->uNumBuf * sizeof(AL_TBufPoolSlot));
 
-  if(!pBufPool->pPool)
+  if(!pBufPool->pPool || !pBufPool->pSlots)
     goto fail_alloc_pool;
 
   // Create uMin free buffers
@@ -152,7 +205,9 @@ void AL_BufPool_Deinit(AL_TBufPool* pBufPool)
 
   if(pBufPool->config.pMetaData)
     pBufPool->config.pMetaData->MetaDestroy(pBufPool->config.pMetaData);
-  Fifo_Deinit(&pBufPool->fifo);
+  if(pBufPool->hFreeSem)
+    Rtos_DeleteSemaphore(pBufPool->hFreeSem);
+  Rtos_Free(pBufPool->pSlots);
   Rtos_Free(pBufPool->pPool);
   Rtos_Memset(pBufPool, 0, sizeof(*pBufPool));
 }
@@ -162,7 +217,26 @@ AL_TBuffer* AL_BufPool_GetBuffer(AL_TBufPool* pBufPool, AL_EBufMode eMode)
 {
   uint32_t Wait = AL_GetWaitMode(eMode);
 
-  auto pBuf = (AL_TBuffer*)Fifo_Dequeue(&pBufPool->fifo, Wait);
+  auto pBuf = PopFree(pBufPool);
+
+  while(!pBuf && Wait != AL_NO_WAIT)
+  {
+    /* register before checking again, so that a concurrent release either
+     * gives us its buffer here or sees us and wakes us up */
+    __atomic_add_fetch(&pBufPool->iNumWaiters, 1, __ATOMIC_SEQ_CST);
+    pBuf = PopFree(pBufPool);
+
+    bool bDecommitted = __atomic_load_n(&pBufPool->bDecommitted, __ATOMIC_SEQ_CST);
+    bool bWoken = pBuf || bDecommitted || Rtos_GetSemaphore(pBufPool->hFreeSem, Wait);
+    __atomic_sub_fetch(&pBufPool->iNumWaiters, 1, __ATOMIC_SEQ_CST);
+
+    if(!pBuf && (bDecommitted || !bWoken))
+      return NULL;
+
+    /* the semaphore can hold stale posts: go around until we get a buffer */
+    if(!pBuf)
+      pBuf = PopFree(pBufPool);
+  }
 
   if(!pBuf)
     return NULL;
@@ -192,112 +266,16 @@ bool AL_BufPool_AddMetaData(AL_TBufPool* pBufPool, AL_TMetaData* pMetaData)
 /****************************************************************************/
 void AL_BufPool_Decommit(AL_TBufPool* pBufPool)
 {
-  Fifo_Decommit(&pBufPool->fifo);
-}
+  __atomic_store_n(&pBufPool->bDecommitted, true, __ATOMIC_SEQ_CST);
 
-static bool Fifo_Init(App_Fifo* pFifo, size_t zMaxElem)
-{
-  pFifo->m_zMaxElem = zMaxElem + 1;
-  pFifo->m_zTail = 0;
-  pFifo->m_zHead = 0;
-  pFifo->m_iBufNumber = 0;
-  pFifo->m_isDecommited = false;
-
-  size_t zElemSize = pFifo->m_zMaxElem * sizeof(void*);
-  pFifo->m_ElemBuffer = (void**)Rtos_Malloc(zElemSize);
-
-  if(!pFifo->m_ElemBuffer)
-    return false;
-  Rtos_Memset(pFifo->m_ElemBuffer, 0xCD, zElemSize);
-
-  pFifo->hEvent = Rtos_CreateEvent(0);
-
-  if(!pFifo->hEvent)
-  {
-    Rtos_Free(pFifo->m_ElemBuffer);
-    return false;
-  }
+  /* the waiters registered after this point see the flag */
+  int iNumWaiters = __atomic_load_n(&pBufPool->iNumWaiters, __ATOMIC_SEQ_CST);
 
-  pFifo->hSpaceSem = Rtos_CreateSemaphore(zMaxElem);
-  pFifo->hMutex = Rtos_CreateMutex();
-
-  if(!pFifo->hSpaceSem)
-  {
-    Rtos_DeleteEvent(pFifo->hEvent);
-    Rtos_Free(pFifo->m_ElemBuffer);
-    return false;
-  }
-
-  return true;
-}
-
-static void Fifo_Deinit(App_Fifo* pFifo)
-{
-  Rtos_Free(pFifo->m_ElemBuffer);
-  Rtos_DeleteEvent(pFifo->hEvent);
-  Rtos_DeleteSemaphore(pFifo->hSpaceSem);
-  Rtos_DeleteMutex(pFifo->hMutex);
-}
-
-static bool Fifo_Queue(App_Fifo* pFifo, void* pElem, uint32_t uWait)
-{
-  if(!Rtos_GetSemaphore(pFifo->hSpaceSem, uWait))
-    return false;
-
-  Rtos_GetMutex(pFifo->hMutex);
-  pFifo->m_ElemBuffer[pFifo->m_zTail] = pElem;
-  pFifo->m_zTail = (pFifo->m_zTail + 1) % pFifo->m_zMaxElem;
-  ++pFifo->m_iBufNumber;
-  Rtos_SetEvent(pFifo->hEvent);
-  Rtos_ReleaseMutex(pFifo->hMutex);
-
-  /* new item was added in the queue */
-  return true;
-}
-
-static void* Fifo_Dequeue(App_Fifo* pFifo, uint32_t uWait)
-{
-  /* wait if no items */
-  Rtos_GetMutex(pFifo->hMutex);
-  bool failed = false;
-
-  while(true)
-  {
-    if(pFifo->m_iBufNumber > 0)
-      break;
-
-    if(failed || pFifo->m_isDecommited)
-    {
-      Rtos_ReleaseMutex(pFifo->hMutex);
-      return NULL;
-    }
-
-    Rtos_ReleaseMutex(pFifo->hMutex);
-
-    if(!Rtos_WaitEvent(pFifo->hEvent, uWait))
-      failed = true;
-
-    Rtos_GetMutex(pFifo->hMutex);
-  }
-
-  void* pElem = pFifo->m_ElemBuffer[pFifo->m_zHead];
-  pFifo->m_zHead = (pFifo->m_zHead + 1) % pFifo->m_zMaxElem;
-  --pFifo->m_iBufNumber;
-  Rtos_ReleaseMutex(pFifo->hMutex);
-
-  /* new empty space available */
-  Rtos_ReleaseSemaphore(pFifo->hSpaceSem);
-  return pElem;
-}
-
-static void Fifo_Decommit(App_Fifo* pFifo)
-{
-  Rtos_GetMutex(pFifo->hMutex);
-  pFifo->m_isDecommited = true;
-  Rtos_SetEvent(pFifo->hEvent);
-  Rtos_ReleaseMutex(pFifo->hMutex);
+  for(int i = 0; i < iNumWaiters; ++i)
+    Rtos_ReleaseSemaphore(pBufPool->hFreeSem);
 }
 
+/****************************************************************************/
 uint32_t AL_GetWaitMode(AL_EBufMode eMode)
 {
   uint32_t Wait = 0;
@@ -65,18 +65,16 @@ typedef struct al_t_BufPoolConfig
   AL_TMetaData* pMetaData;/*!< Metadata of the buffer that will fill the pool */
 }AL_TBufPoolConfig;
 
+struct al_t_BufPool;
+
+/*************************************************************************//*!
+   \brief AL_TBufPoolSlot: Free-stack link of a buffer of the pool
+*****************************************************************************/
 typedef struct
 {
-  size_t m_zMaxElem;
-  size_t m_zTail;
-  size_t m_zHead;
-  void** m_ElemBuffer;
-  AL_MUTEX hMutex;
-  AL_EVENT hEvent;
-  int m_iBufNumber;
-  bool m_isDecommited;
-  AL_SEMAPHORE hSpaceSem;
-}App_Fifo;
+  struct al_t_BufPool* pBufPool;
+  uint32_t uNext; /*! index + 1 of the next free buffer, 0 at the bottom of the stack */
+}AL_TBufPoolSlot;
 
 /*************************************************************************//*!
    \brief Buffer Access mode: Do we want to wait if no buffer is available or to fail fast.
@@ -94,16 +92,20 @@ uint32_t AL_GetWaitMode(AL_EBufMode eMode);
 /*************************************************************************//*!
    \brief AL_TBufPool: Pool of buffer
 *****************************************************************************/
-typedef struct
+typedef struct al_t_BufPool
 {
   AL_TAllocator* pAllocator; /*! Allocator used to allocate the buffers */
 
   AL_TBuffer** pPool; /*! pool of allocated buffers */
+  AL_TBufPoolSlot* pSlots; /*! free-stack links, one per buffer */
   uint32_t uNumBuf; /*! Number of buffer in the pool */
 
   AL_TBufPoolConfig config;
 
-  App_Fifo fifo;
+  uint64_t uFreeHead; /*! top of the lock-free free stack: ABA tag << 32 | (index + 1) */
+  int iNumWaiters; /*! number of AL_BUF_MODE_BLOCK getters sleeping on an empty pool */
+  bool bDecommitted;
+  AL_SEMAPHORE hFreeSem; /*! wakes up the waiters, only posted when there are some */
 }AL_TBufPool;
 
 /*************************************************************************//*!
@@ -94,5 +94,6 @@ enum SCHEDULER_TYPE
 {
   SCHEDULER_TYPE_CPU,
   SCHEDULER_TYPE_MCU,
+  SCHEDULER_TYPE_MCU_REACTOR, // MCU, the statuses are dispatched by an event reactor
 };
 
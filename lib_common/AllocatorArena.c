@@ -0,0 +1,197 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#include <assert.h>
+#include "lib_common/Allocator.h"
+#include "lib_rtos/lib_rtos.h"
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_ALIGN(zSize) (((zSize) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+typedef struct t_ArenaChunk
+{
+  struct t_ArenaChunk* pNext;
+  size_t zSize;
+  size_t zUsed;
+}AL_TArenaChunk;
+
+typedef struct
+{
+  AL_TAllocator base;
+  AL_MUTEX hMutex;
+  size_t zChunkSize;
+  AL_TArenaChunk* pChunks; // The head is the chunk allocations are carved from
+}AL_TArenaAllocator;
+
+#define ARENA_CHUNK_HEADER_SIZE ARENA_ALIGN(sizeof(AL_TArenaChunk))
+
+/*****************************************************************************/
+static AL_TArenaChunk* AL_sArenaAllocator_CreateChunk(size_t zSize)
+{
+  AL_TArenaChunk* pChunk = (AL_TArenaChunk*)Rtos_Malloc(ARENA_CHUNK_HEADER_SIZE + zSize);
+
+  if(!pChunk)
+    return NULL;
+
+  pChunk->pNext = NULL;
+  pChunk->zSize = zSize;
+  pChunk->zUsed = 0;
+  return pChunk;
+}
+
+/*****************************************************************************/
+static bool AL_sArenaAllocator_Destroy(AL_TAllocator* pAllocator)
+{
+  AL_TArenaAllocator* pArena = (AL_TArenaAllocator*)pAllocator;
+  AL_TArenaChunk* pChunk = pArena->pChunks;
+
+  while(pChunk)
+  {
+    AL_TArenaChunk* pNext = pChunk->pNext;
+    Rtos_Free(pChunk);
+    pChunk = pNext;
+  }
+
+  Rtos_DeleteMutex(pArena->hMutex);
+  Rtos_Free(pArena);
+  return true;
+}
+
+/*****************************************************************************/
+static AL_HANDLE AL_sArenaAllocator_Alloc(AL_TAllocator* pAllocator, size_t zSize)
+{
+  AL_TArenaAllocator* pArena = (AL_TArenaAllocator*)pAllocator;
+  zSize = ARENA_ALIGN(zSize ? zSize : 1);
+
+  Rtos_GetMutex(pArena->hMutex);
+
+  AL_TArenaChunk* pChunk = pArena->pChunks;
+
+  if(!pChunk || pChunk->zUsed + zSize > pChunk->zSize)
+  {
+    // big requests get their own chunk, so that the current one keeps being filled
+    bool bDedicated = pChunk && (zSize > pArena->zChunkSize / 2);
+    AL_TArenaChunk* pNew = AL_sArenaAllocator_CreateChunk(bDedicated || zSize > pArena->zChunkSize ? zSize : pArena->zChunkSize);
+
+    if(!pNew)
+    {
+      Rtos_ReleaseMutex(pArena->hMutex);
+      return NULL;
+    }
+
+    if(bDedicated)
+    {
+      pNew->pNext = pChunk->pNext;
+      pChunk->pNext = pNew;
+    }
+    else
+    {
+      pNew->pNext = pChunk;
+      pArena->pChunks = pNew;
+    }
+    pChunk = pNew;
+  }
+
+  uint8_t* pData = (uint8_t*)pChunk + ARENA_CHUNK_HEADER_SIZE + pChunk->zUsed;
+  pChunk->zUsed += zSize;
+
+  Rtos_ReleaseMutex(pArena->hMutex);
+
+  return (AL_HANDLE)pData;
+}
+
+/*****************************************************************************/
+static bool AL_sArenaAllocator_Free(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
+{
+  // memory is given back all at once when the arena is destroyed
+  (void)pAllocator;
+  (void)hBuf;
+  return true;
+}
+
+/*****************************************************************************/
+static AL_VADDR AL_sArenaAllocator_GetVirtualAddr(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
+{
+  (void)pAllocator;
+  return (AL_VADDR)hBuf;
+}
+
+/*****************************************************************************/
+static AL_PADDR AL_sArenaAllocator_GetPhysicalAddr(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
+{
+  (void)pAllocator;
+  (void)hBuf;
+  return (AL_PADDR)0;
+}
+
+/*****************************************************************************/
+static const AL_AllocatorVtable s_ArenaAllocatorVtable =
+{
+  AL_sArenaAllocator_Destroy,
+  AL_sArenaAllocator_Alloc,
+  AL_sArenaAllocator_Free,
+  AL_sArenaAllocator_GetVirtualAddr,
+  AL_sArenaAllocator_GetPhysicalAddr,
+  NULL,
+};
+
+/*****************************************************************************/
+AL_TAllocator* AL_ArenaAllocator_Create(size_t zChunkSize)
+{
+  assert(zChunkSize > 0);
+
+  AL_TArenaAllocator* pArena = (AL_TArenaAllocator*)Rtos_Malloc(sizeof(*pArena));
+
+  if(!pArena)
+    return NULL;
+
+  pArena->base.vtable = &s_ArenaAllocatorVtable;
+  pArena->zChunkSize = ARENA_ALIGN(zChunkSize);
+  pArena->hMutex = Rtos_CreateMutex();
+  pArena->pChunks = AL_sArenaAllocator_CreateChunk(pArena->zChunkSize);
+
+  if(!pArena->hMutex || !pArena->pChunks)
+  {
+    Rtos_Free(pArena->pChunks);
+    Rtos_DeleteMutex(pArena->hMutex);
+    Rtos_Free(pArena);
+    return NULL;
+  }
+
+  return (AL_TAllocator*)pArena;
+}
+
@@ -0,0 +1,283 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#include <assert.h>
+#include "lib_common/Allocator.h"
+#include "lib_rtos/lib_rtos.h"
+
+/* Frame sized host buffers are spread over thousands of 4KB pages: the copy
+ * and conversion loops walking them miss in the dTLB all the time. Backing
+ * them with 2MB pages divides the number of translations by 512. */
+
+typedef struct
+{
+  uint8_t* pData;
+  void* pMap; /* NULL if pData comes from Rtos_Malloc */
+  size_t zMapSize;
+}AL_THugePageBuf;
+
+typedef struct
+{
+  AL_TAllocator base;
+  int iNumaNode;
+}AL_THugePageAllocator;
+
+#if __linux__
+
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* The default hugetlb size depends on the architecture and on the kernel command
+ * line, so ask for 2MB pages explicitly: that is also the THP size on 4KB page systems */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#define HUGE_PAGE_ALIGN(zSize) (((zSize) + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1))
+
+/* smaller buffers would waste most of their hugepage */
+#define MIN_HUGE_PAGE_ALLOC (HUGE_PAGE_SIZE / 2)
+
+/* MPOL_BIND from linux/mempolicy.h: the libc headers don't export the NUMA policies */
+#define AL_MPOL_BIND 2
+
+/*****************************************************************************/
+static void BindToNumaNode(void* pMap, size_t zMapSize, int iNumaNode)
+{
+  unsigned long uNodeMask = 1UL << iNumaNode;
+
+  /* The kernel only looks at maxnode - 1 bits. The binding is a hint: the memory
+   * stays usable if the node doesn't exist or the kernel doesn't support NUMA */
+  if(syscall(SYS_mbind, pMap, zMapSize, AL_MPOL_BIND, &uNodeMask, sizeof(uNodeMask) * 8 + 1, 0) != 0)
+    perror("mbind");
+}
+
+/*****************************************************************************/
+static void* MapTransparentHugePages(size_t zMapSize)
+{
+  /* over-allocate to get a hugepage aligned range the kernel can back with THP */
+  size_t zRawSize = zMapSize + HUGE_PAGE_SIZE;
+  uint8_t* pRaw = (uint8_t*)mmap(NULL, zRawSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if(pRaw == MAP_FAILED)
+    return NULL;
+
+  uint8_t* pMap = (uint8_t*)HUGE_PAGE_ALIGN((uintptr_t)pRaw);
+  size_t zHead = pMap - pRaw;
+  size_t zTail = zRawSize - zHead - zMapSize;
+
+  if(zHead)
+    munmap(pRaw, zHead);
+
+  if(zTail)
+    munmap(pMap + zMapSize, zTail);
+
+#ifdef MADV_HUGEPAGE
+  madvise(pMap, zMapSize, MADV_HUGEPAGE);
+#endif
+
+  return pMap;
+}
+
+/*****************************************************************************/
+static void* MapHugePages(size_t zMapSize, int iNumaNode)
+{
+  void* pMap = mmap(NULL, zMapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+
+  /* the 2MB hugetlb pool is often empty or missing: fall back to transparent hugepages */
+  if(pMap == MAP_FAILED)
+    pMap = MapTransparentHugePages(zMapSize);
+
+  /* pages are only faulted in on first touch, after the binding */
+  if(pMap && iNumaNode >= 0)
+    BindToNumaNode(pMap, zMapSize, iNumaNode);
+
+  return pMap;
+}
+
+/*****************************************************************************/
+static void UnmapHugePages(void* pMap, size_t zMapSize)
+{
+  if(munmap(pMap, zMapSize) != 0)
+    perror("munmap");
+}
+
+#else
+
+#define MIN_HUGE_PAGE_ALLOC SIZE_MAX
+#define HUGE_PAGE_ALIGN(zSize) (zSize)
+
+/*****************************************************************************/
+static void* MapHugePages(size_t zMapSize, int iNumaNode)
+{
+  (void)zMapSize, (void)iNumaNode;
+  return NULL;
+}
+
+/*****************************************************************************/
+static void UnmapHugePages(void* pMap, size_t zMapSize)
+{
+  (void)pMap, (void)zMapSize;
+  assert(0);
+}
+
+#endif
+
+/*****************************************************************************/
+static bool AL_sHugePageAllocator_Destroy(AL_TAllocator* pAllocator)
+{
+  Rtos_Free(pAllocator);
+  return true;
+}
+
+/*****************************************************************************/
+static AL_HANDLE AL_sHugePageAllocator_Alloc(AL_TAllocator* pAllocator, size_t zSize)
+{
+  AL_THugePageAllocator* pHuge = (AL_THugePageAllocator*)pAllocator;
+  AL_THugePageBuf* pBuf = (AL_THugePageBuf*)Rtos_Malloc(sizeof(*pBuf));
+
+  if(!pBuf)
+    return NULL;
+
+  pBuf->pMap = NULL;
+  pBuf->zMapSize = 0;
+
+  if(zSize >= MIN_HUGE_PAGE_ALLOC)
+  {
+    pBuf->zMapSize = HUGE_PAGE_ALIGN(zSize);
+    pBuf->pMap = MapHugePages(pBuf->zMapSize, pHuge->iNumaNode);
+  }
+
+  pBuf->pData = pBuf->pMap ? (uint8_t*)pBuf->pMap : (uint8_t*)Rtos_Malloc(zSize);
+
+  if(!pBuf->pData)
+  {
+    Rtos_Free(pBuf);
+    return NULL;
+  }
+
+  return (AL_HANDLE)pBuf;
+}
+
+/*****************************************************************************/
+static bool AL_sHugePageAllocator_Free(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
+{
+  (void)pAllocator;
+  AL_THugePageBuf* pBuf = (AL_THugePageBuf*)hBuf;
+
+  if(!pBuf)
+    return true;
+
+  if(pBuf->pMap)
+    UnmapHugePages(pBuf->pMap, pBuf->zMapSize);
+  else
+    Rtos_Free(pBuf->pData);
+
+  Rtos_Free(pBuf);
+  return true;
+}
+
+/*****************************************************************************/
+static AL_VADDR AL_sHugePageAllocator_GetVirtualAddr(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
+{
+  (void)pAllocator;
+  AL_THugePageBuf* pBuf = (AL_THugePageBuf*)hBuf;
+  return pBuf ? (AL_VADDR)pBuf->pData : NULL;
+}
+
+/*****************************************************************************/
+static AL_PADDR AL_sHugePageAllocator_GetPhysicalAddr(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
+{
+  (void)pAllocator;
+  (void)hBuf;
+  return (AL_PADDR)0;
+}
+
+/*****************************************************************************/
+static const AL_AllocatorVtable s_HugePageAllocatorVtable =
+{
+  AL_sHugePageAllocator_Destroy,
+  AL_sHugePageAllocator_Alloc,
+  AL_sHugePageAllocator_Free,
+  AL_sHugePageAllocator_GetVirtualAddr,
+  AL_sHugePageAllocator_GetPhysicalAddr,
+  NULL,
+};
+
+static const AL_AllocatorVtable s_SharedHugePageAllocatorVtable =
+{
+  NULL,
+  AL_sHugePageAllocator_Alloc,
+  AL_sHugePageAllocator_Free,
+  AL_sHugePageAllocator_GetVirtualAddr,
+  AL_sHugePageAllocator_GetPhysicalAddr,
+  NULL,
+};
+
+static AL_THugePageAllocator s_HugePageAllocator =
+{
+  { &s_SharedHugePageAllocatorVtable }, -1
+};
+
+/*****************************************************************************/
+AL_TAllocator* AL_GetHugePageAllocator()
+{
+  return (AL_TAllocator*)&s_HugePageAllocator;
+}
+
+/*****************************************************************************/
+AL_TAllocator* AL_HugePageAllocator_Create(int iNumaNode)
+{
+  assert(iNumaNode >= -1 && iNumaNode < (int)(sizeof(unsigned long) * 8));
+
+  AL_THugePageAllocator* pHuge = (AL_THugePageAllocator*)Rtos_Malloc(sizeof(*pHuge));
+
+  if(!pHuge)
+    return NULL;
+
+  pHuge->base.vtable = &s_HugePageAllocatorVtable;
+  pHuge->iNumaNode = iNumaNode;
+
+  return (AL_TAllocator*)pHuge;
+}
@@ -102,6 +102,18 @@ int AL_StreamMetaData_AddSection(AL_TStreamMetaData* pMetaData, uint32_t uOffset
   return uSectionID;
 }
 
+/****************************************************************************/
+AL_TStreamSection* AL_StreamMetaData_AppendSections(AL_TStreamMetaData* pMetaData, uint16_t uNumSections)
+{
+  if(!pMetaData || pMetaData->uNumSection + uNumSections > pMetaData->uMaxNumSection)
+    return NULL;
+
+  AL_TStreamSection* pNewSections = &pMetaData->pSections[pMetaData->uNumSection];
+  pMetaData->uNumSection += uNumSections;
+
+  return pNewSections;
+}
+
 /****************************************************************************/
 void AL_StreamMetaData_ChangeSection(AL_TStreamMetaData* pMetaData, uint16_t uSectionID, uint32_t uOffset, uint32_t uLength)
 {
@@ -35,6 +35,7 @@
 *
 ******************************************************************************/
 
+#include <assert.h>
 #include "ChannelResources.h"
 #include "Utils.h"
 
@@ -96,3 +97,173 @@ int AL_GetResources(int width, int height, int frameRate, int clockRatio)
   return divideRoundUp(dividende, divisor);
 }
 
+bool AL_ResourceLedger_Init(AL_TResourceLedger* ledger, AL_CoreConstraint const* constraint, int numCores)
+{
+  assert(numCores > 0 && numCores <= AL_LEDGER_MAX_CORES);
+
+  ledger->mutex = Rtos_CreateMutex();
+
+  if(!ledger->mutex)
+    return false;
+
+  ledger->constraint = *constraint;
+  ledger->numCores = numCores;
+
+  for(int core = 0; core < AL_LEDGER_MAX_CORES; ++core)
+    ledger->coreLoad[core] = 0;
+
+  return true;
+}
+
+void AL_ResourceLedger_Deinit(AL_TResourceLedger* ledger)
+{
+  Rtos_DeleteMutex(ledger->mutex);
+  ledger->mutex = NULL;
+}
+
+static int getFreeResources(AL_TResourceLedger const* ledger)
+{
+  int freeResources = 0;
+
+  for(int core = 0; core < ledger->numCores; ++core)
+    freeResources += ledger->constraint.resources - ledger->coreLoad[core];
+
+  return freeResources;
+}
+
+/* The load is spread evenly over the channel cores: book it on the least loaded ones */
+static bool placeChannel(AL_TResourceLedger const* ledger, AL_TAdmission* admission)
+{
+  admission->coreMask = 0;
+
+  if(admission->numCores > ledger->numCores)
+    return false;
+
+  int coreShare = divideRoundUp(admission->resources, admission->numCores);
+  bool fits = true;
+
+  for(int i = 0; i < admission->numCores; ++i)
+  {
+    int leastLoaded = -1;
+
+    for(int core = 0; core < ledger->numCores; ++core)
+    {
+      if(admission->coreMask & (1u << core))
+        continue;
+
+      if(leastLoaded < 0 || ledger->coreLoad[core] < ledger->coreLoad[leastLoaded])
+        leastLoaded = core;
+    }
+
+    admission->coreMask |= 1u << leastLoaded;
+
+    if(ledger->coreLoad[leastLoaded] + coreShare > ledger->constraint.resources)
+      fits = false;
+  }
+
+  return fits;
+}
+
+static bool queryChannel(AL_TResourceLedger* ledger, int width, int height, int frameRate, int clockRatio, int numCores, AL_TAdmission* admission)
+{
+  AL_CoreConstraint* constraint = &ledger->constraint;
+
+  admission->resources = AL_GetResources(width, height, frameRate, clockRatio);
+  admission->numCores = numCores ? numCores : AL_CoreConstraint_GetExpectedNumberOfCores(constraint, width, height, frameRate, clockRatio);
+  admission->headroom = getFreeResources(ledger) - admission->resources;
+
+  if(admission->numCores < AL_CoreConstraint_GetMinCoresCount(constraint, width))
+    return false;
+
+  return placeChannel(ledger, admission);
+}
+
+bool AL_ResourceLedger_Query(AL_TResourceLedger* ledger, int width, int height, int frameRate, int clockRatio, int numCores, AL_TAdmission* admission)
+{
+  Rtos_GetMutex(ledger->mutex);
+  bool fits = queryChannel(ledger, width, height, frameRate, clockRatio, numCores, admission);
+  Rtos_ReleaseMutex(ledger->mutex);
+  return fits;
+}
+
+bool AL_ResourceLedger_Admit(AL_TResourceLedger* ledger, int width, int height, int frameRate, int clockRatio, int numCores, AL_TAdmission* admission)
+{
+  Rtos_GetMutex(ledger->mutex);
+  bool fits = queryChannel(ledger, width, height, frameRate, clockRatio, numCores, admission);
+
+  if(fits)
+  {
+    int coreShare = divideRoundUp(admission->resources, admission->numCores);
+
+    for(int core = 0; core < ledger->numCores; ++core)
+    {
+      if(admission->coreMask & (1u << core))
+        ledger->coreLoad[core] += coreShare;
+    }
+  }
+
+  Rtos_ReleaseMutex(ledger->mutex);
+  return fits;
+}
+
+void AL_ResourceLedger_Release(AL_TResourceLedger* ledger, AL_TAdmission const* admission)
+{
+  int coreShare = divideRoundUp(admission->resources, admission->numCores);
+
+  Rtos_GetMutex(ledger->mutex);
+
+  for(int core = 0; core < ledger->numCores; ++core)
+  {
+    if(admission->coreMask & (1u << core))
+    {
+      ledger->coreLoad[core] -= coreShare;
+      assert(ledger->coreLoad[core] >= 0);
+    }
+  }
+
+  Rtos_ReleaseMutex(ledger->mutex);
+}
+
+int AL_ResourceLedger_GetHeadroom(AL_TResourceLedger* ledger)
+{
+  Rtos_GetMutex(ledger->mutex);
+  int headroom = getFreeResources(ledger);
+  Rtos_ReleaseMutex(ledger->mutex);
+  return headroom;
+}
+
+static AL_TResourceLedger* s_pEncoderLedger;
+
+AL_TResourceLedger* AL_GetEncoderResourceLedger(void)
+{
+  AL_TResourceLedger* ledger = __atomic_load_n(&s_pEncoderLedger, __ATOMIC_ACQUIRE);
+
+  if(ledger)
+    return ledger;
+
+  ledger = (AL_TResourceLedger*)Rtos_Malloc(sizeof(*ledger));
+
+  if(!ledger)
+    return NULL;
+
+  AL_CoreConstraint constraint;
+  AL_CoreConstraint_Init(&constraint, ENCODER_CORE_FREQUENCY, ENCODER_CORE_FREQUENCY_MARGIN, ENCODER_CYCLES_FOR_BLK_32X32, 0, AL_ENC_CORE_MAX_WIDTH);
+
+  if(!AL_ResourceLedger_Init(ledger, &constraint, AL_ENC_NUM_CORES))
+  {
+    Rtos_Free(ledger);
+    return NULL;
+  }
+
+  AL_TResourceLedger* expected = NULL;
+
+  /* lives as long as the process. Several threads can race on the first call */
+  if(!__atomic_compare_exchange_n(&s_pEncoderLedger, &expected, ledger, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+  {
+    AL_ResourceLedger_Deinit(ledger);
+    Rtos_Free(ledger);
+    return expected;
+  }
+
+  return ledger;
+}
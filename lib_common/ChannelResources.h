@@ -37,6 +37,8 @@
 
 #pragma once
 #include "lib_rtos/types.h"
+#include "lib_rtos/lib_rtos.h"
+#include "lib_common/ResourceLedger.h"
 
 typedef struct
 {
@@ -52,3 +54,17 @@ int AL_CoreConstraint_GetMinCoresCount(AL_CoreConstraint* constraint, int width)
 
 int AL_GetResources(int width, int height, int frameRate, int clockRatio);
 
+#define AL_LEDGER_MAX_CORES 16
+
+/* Each core can process constraint.resources 32x32 blocks per second; a
+ * channel running on n cores takes 1/n of its load on each. */
+struct AL_t_ResourceLedger
+{
+  AL_CoreConstraint constraint;
+  int numCores;
+  int coreLoad[AL_LEDGER_MAX_CORES];
+  AL_MUTEX mutex;
+};
+
+bool AL_ResourceLedger_Init(AL_TResourceLedger* ledger, AL_CoreConstraint const* constraint, int numCores);
+void AL_ResourceLedger_Deinit(AL_TResourceLedger* ledger);
@@ -0,0 +1,367 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#include "lib_common/EventReactor.h"
+
+#if __linux__
+
+#include <assert.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "lib_rtos/lib_rtos.h"
+#include "lib_common/List.h"
+
+#define MAX_EVENTS_PER_WAIT 16
+#define STOP_ID 0
+
+typedef struct
+{
+  AL_TEventReactor* pReactor;
+  int epollFd;
+  AL_THREAD thread;
+  /* held while dispatching, so that a removed source is never called back */
+  AL_MUTEX hDispatchMutex;
+  AL_ListHead sources;
+  int iNumSources;
+}AL_TEventThread;
+
+struct AL_t_EventSource
+{
+  AL_ListHead list;
+  AL_TEventThread* pThread;
+  AL_64U uID;
+  int fd;
+  bool bWatched;
+  AL_FCN_OnEvent pfnOnEvent;
+  void* pUserParam;
+};
+
+struct AL_t_EventReactor
+{
+  int stopFd;
+  AL_MUTEX hMutex;
+  AL_64U uNextID;
+  int iNumThreads;
+  AL_TEventThread threads[];
+};
+
+/****************************************************************************/
+static AL_TEventSource* FindSource(AL_TEventThread* pThread, AL_64U uID)
+{
+  for(AL_ListHead* pNode = pThread->sources.pNext; pNode != &pThread->sources; pNode = pNode->pNext)
+  {
+    AL_TEventSource* pSource = AL_ListEntry(pNode, AL_TEventSource, list);
+
+    if(pSource->uID == uID)
+      return pSource;
+  }
+
+  return NULL;
+}
+
+/****************************************************************************/
+static void Dispatch(AL_TEventThread* pThread, struct epoll_event* pEvent)
+{
+  /* the event might come from a source removed since epoll_wait returned:
+   * sources are looked up by id, which are never reused */
+  AL_TEventSource* pSource = FindSource(pThread, pEvent->data.u64);
+
+  if(!pSource || !pSource->bWatched)
+    return;
+
+  if(!pSource->pfnOnEvent(pSource->pUserParam))
+  {
+    epoll_ctl(pThread->epollFd, EPOLL_CTL_DEL, pSource->fd, NULL);
+    pSource->bWatched = false;
+  }
+}
+
+/****************************************************************************/
+static void* EventThread(void* p)
+{
+  AL_TEventThread* pThread = p;
+  struct epoll_event events[MAX_EVENTS_PER_WAIT];
+
+  while(true)
+  {
+    int iNumEvents = epoll_wait(pThread->epollFd, events, MAX_EVENTS_PER_WAIT, -1);
+
+    if(iNumEvents < 0)
+      continue; // EINTR
+
+    Rtos_GetMutex(pThread->hDispatchMutex);
+
+    for(int i = 0; i < iNumEvents; ++i)
+    {
+      if(events[i].data.u64 == STOP_ID)
+      {
+        Rtos_ReleaseMutex(pThread->hDispatchMutex);
+        return NULL;
+      }
+
+      Dispatch(pThread, &events[i]);
+    }
+
+    Rtos_ReleaseMutex(pThread->hDispatchMutex);
+  }
+}
+
+/****************************************************************************/
+static bool InitThread(AL_TEventThread* pThread, AL_TEventReactor* pReactor)
+{
+  pThread->pReactor = pReactor;
+  pThread->iNumSources = 0;
+  AL_ListHeadInit(&pThread->sources);
+
+  pThread->epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+  if(pThread->epollFd < 0)
+    return false;
+
+  /* the stop eventfd is never read: once written, it wakes every thread */
+  struct epoll_event stopEvent = { 0 };
+  stopEvent.events = EPOLLIN;
+  stopEvent.data.u64 = STOP_ID;
+
+  if(epoll_ctl(pThread->epollFd, EPOLL_CTL_ADD, pReactor->stopFd, &stopEvent) < 0)
+    goto fail_ctl;
+
+  pThread->hDispatchMutex = Rtos_CreateMutex();
+
+  if(!pThread->hDispatchMutex)
+    goto fail_ctl;
+
+  pThread->thread = Rtos_CreateThread(&EventThread, pThread);
+
+  if(!pThread->thread)
+    goto fail_thread;
+
+  return true;
+
+  fail_thread:
+  Rtos_DeleteMutex(pThread->hDispatchMutex);
+  fail_ctl:
+  close(pThread->epollFd);
+  return false;
+}
+
+/****************************************************************************/
+static void DeinitThread(AL_TEventThread* pThread)
+{
+  assert(AL_ListEmpty(&pThread->sources));
+  Rtos_JoinThread(pThread->thread);
+  Rtos_DeleteThread(pThread->thread);
+  Rtos_DeleteMutex(pThread->hDispatchMutex);
+  close(pThread->epollFd);
+}
+
+/****************************************************************************/
+static void StopThreads(AL_TEventReactor* pReactor, int iNumThreads)
+{
+  uint64_t uStop = 1;
+
+  if(write(pReactor->stopFd, &uStop, sizeof(uStop)) != sizeof(uStop))
+    assert(0);
+
+  for(int i = 0; i < iNumThreads; ++i)
+    DeinitThread(&pReactor->threads[i]);
+}
+
+/****************************************************************************/
+AL_TEventReactor* AL_EventReactor_Create(int iNumThreads)
+{
+  if(iNumThreads <= 0)
+    return NULL;
+
+  AL_TEventReactor* pReactor = Rtos_Malloc(sizeof(*pReactor) + iNumThreads * sizeof(AL_TEventThread));
+
+  if(!pReactor)
+    return NULL;
+
+  pReactor->uNextID = STOP_ID + 1;
+  pReactor->iNumThreads = 0;
+  pReactor->hMutex = Rtos_CreateMutex();
+
+  if(!pReactor->hMutex)
+    goto fail_mutex;
+
+  pReactor->stopFd = eventfd(0, EFD_CLOEXEC);
+
+  if(pReactor->stopFd < 0)
+    goto fail_eventfd;
+
+  for(; pReactor->iNumThreads < iNumThreads; ++pReactor->iNumThreads)
+  {
+    if(!InitThread(&pReactor->threads[pReactor->iNumThreads], pReactor))
+      goto fail_thread;
+  }
+
+  return pReactor;
+
+  fail_thread:
+  StopThreads(pReactor, pReactor->iNumThreads);
+  close(pReactor->stopFd);
+  fail_eventfd:
+  Rtos_DeleteMutex(pReactor->hMutex);
+  fail_mutex:
+  Rtos_Free(pReactor);
+  return NULL;
+}
+
+/****************************************************************************/
+void AL_EventReactor_Destroy(AL_TEventReactor* pReactor)
+{
+  if(!pReactor)
+    return;
+
+  StopThreads(pReactor, pReactor->iNumThreads);
+  close(pReactor->stopFd);
+  Rtos_DeleteMutex(pReactor->hMutex);
+  Rtos_Free(pReactor);
+}
+
+/****************************************************************************/
+static AL_TEventThread* GetLeastLoadedThread(AL_TEventReactor* pReactor)
+{
+  AL_TEventThread* pBest = &pReactor->threads[0];
+
+  for(int i = 1; i < pReactor->iNumThreads; ++i)
+  {
+    if(pReactor->threads[i].iNumSources < pBest->iNumSources)
+      pBest = &pReactor->threads[i];
+  }
+
+  return pBest;
+}
+
+/****************************************************************************/
+AL_TEventSource* AL_EventReactor_Add(AL_TEventReactor* pReactor, int fd, AL_FCN_OnEvent pfnOnEvent, void* pUserParam)
+{
+  assert(pReactor);
+  assert(pfnOnEvent);
+
+  AL_TEventSource* pSource = Rtos_Malloc(sizeof(*pSource));
+
+  if(!pSource)
+    return NULL;
+
+  pSource->fd = fd;
+  pSource->bWatched = true;
+  pSource->pfnOnEvent = pfnOnEvent;
+  pSource->pUserParam = pUserParam;
+
+  Rtos_GetMutex(pReactor->hMutex);
+  pSource->uID = pReactor->uNextID++;
+  AL_TEventThread* pThread = GetLeastLoadedThread(pReactor);
+  ++pThread->iNumSources;
+  Rtos_ReleaseMutex(pReactor->hMutex);
+
+  pSource->pThread = pThread;
+
+  /* the source must be known before epoll can report it */
+  Rtos_GetMutex(pThread->hDispatchMutex);
+  AL_ListAddTail(&pSource->list, &pThread->sources);
+  Rtos_ReleaseMutex(pThread->hDispatchMutex);
+
+  struct epoll_event event = { 0 };
+  event.events = EPOLLIN | EPOLLPRI;
+  event.data.u64 = pSource->uID;
+
+  if(epoll_ctl(pThread->epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+  {
+    pSource->bWatched = false;
+    AL_EventReactor_Remove(pReactor, pSource);
+    return NULL;
+  }
+
+  return pSource;
+}
+
+/****************************************************************************/
+void AL_EventReactor_Remove(AL_TEventReactor* pReactor, AL_TEventSource* pSource)
+{
+  if(!pSource)
+    return;
+
+  AL_TEventThread* pThread = pSource->pThread;
+
+  Rtos_GetMutex(pThread->hDispatchMutex);
+
+  if(pSource->bWatched)
+    epoll_ctl(pThread->epollFd, EPOLL_CTL_DEL, pSource->fd, NULL);
+  AL_ListDel(&pSource->list);
+
+  Rtos_ReleaseMutex(pThread->hDispatchMutex);
+
+  Rtos_GetMutex(pReactor->hMutex);
+  --pThread->iNumSources;
+  Rtos_ReleaseMutex(pReactor->hMutex);
+
+  Rtos_Free(pSource);
+}
+
+#else
+
+/****************************************************************************/
+AL_TEventReactor* AL_EventReactor_Create(int iNumThreads)
+{
+  (void)iNumThreads;
+  return NULL;
+}
+
+/****************************************************************************/
+void AL_EventReactor_Destroy(AL_TEventReactor* pReactor)
+{
+  (void)pReactor;
+}
+
+/****************************************************************************/
+AL_TEventSource* AL_EventReactor_Add(AL_TEventReactor* pReactor, int fd, AL_FCN_OnEvent pfnOnEvent, void* pUserParam)
+{
+  (void)pReactor, (void)fd, (void)pfnOnEvent, (void)pUserParam;
+  return NULL;
+}
+
+/****************************************************************************/
+void AL_EventReactor_Remove(AL_TEventReactor* pReactor, AL_TEventSource* pSource)
+{
+  (void)pReactor, (void)pSource;
+}
+
+#endif
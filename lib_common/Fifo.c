@@ -38,23 +38,30 @@
 #include "Fifo.h"
 
 bool AL_Fifo_Init(AL_TFifo* pFifo, size_t zMaxElem)
+{
+  return AL_Fifo_InitWithAllocator(pFifo, zMaxElem, AL_GetDefaultAllocator());
+}
+
+bool AL_Fifo_InitWithAllocator(AL_TFifo* pFifo, size_t zMaxElem, AL_TAllocator* pAllocator)
 {
   pFifo->zMaxElem = zMaxElem + 1;
   pFifo->zTail = 0;
   pFifo->zHead = 0;
+  pFifo->pAllocator = pAllocator;
 
   size_t zElemSize = pFifo->zMaxElem * sizeof(void*);
-  pFifo->ElemBuffer = Rtos_Malloc(zElemSize);
+  pFifo->hElemBuffer = AL_Allocator_Alloc(pAllocator, zElemSize);
 
-  if(!pFifo->ElemBuffer)
+  if(!pFifo->hElemBuffer)
     return false;
+  pFifo->ElemBuffer = (void**)AL_Allocator_GetVirtualAddr(pAllocator, pFifo->hElemBuffer);
   Rtos_Memset(pFifo->ElemBuffer, 0xCD, zElemSize);
 
   pFifo->hCountSem = Rtos_CreateSemaphore(0);
 
   if(!pFifo->hCountSem)
   {
-    Rtos_Free(pFifo->ElemBuffer);
+    AL_Allocator_Free(pAllocator, pFifo->hElemBuffer);
     return false;
   }
 
@@ -64,7 +71,7 @@ bool AL_Fifo_Init(AL_TFifo* pFifo, size_t zMaxElem)
   if(!pFifo->hSpaceSem)
   {
     Rtos_DeleteSemaphore(pFifo->hCountSem);
-    Rtos_Free(pFifo->ElemBuffer);
+    AL_Allocator_Free(pAllocator, pFifo->hElemBuffer);
     return false;
   }
 
@@ -73,7 +80,7 @@ bool AL_Fifo_Init(AL_TFifo* pFifo, size_t zMaxElem)
 
 void AL_Fifo_Deinit(AL_TFifo* pFifo)
 {
-  Rtos_Free(pFifo->ElemBuffer);
+  AL_Allocator_Free(pFifo->pAllocator, pFifo->hElemBuffer);
   Rtos_DeleteSemaphore(pFifo->hCountSem);
   Rtos_DeleteSemaphore(pFifo->hSpaceSem);
   Rtos_DeleteMutex(pFifo->hMutex);
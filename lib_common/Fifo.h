@@ -38,6 +38,7 @@
 #pragma once
 
 #include "lib_rtos/lib_rtos.h"
+#include "lib_common/Allocator.h"
 
 typedef struct
 {
@@ -45,12 +46,15 @@ typedef struct
   size_t zTail;
   size_t zHead;
   void** ElemBuffer;
+  AL_TAllocator* pAllocator;
+  AL_HANDLE hElemBuffer;
   AL_MUTEX hMutex;
   AL_SEMAPHORE hCountSem;
   AL_SEMAPHORE hSpaceSem;
 }AL_TFifo;
 
 bool AL_Fifo_Init(AL_TFifo* pFifo, size_t zMaxElem);
+bool AL_Fifo_InitWithAllocator(AL_TFifo* pFifo, size_t zMaxElem, AL_TAllocator* pAllocator);
 void AL_Fifo_Deinit(AL_TFifo* pFifo);
 bool AL_Fifo_Queue(AL_TFifo* pFifo, void* pElem, uint32_t uWait);
 void* AL_Fifo_Dequeue(AL_TFifo* pFifo, uint32_t uWait);
@@ -105,6 +105,26 @@ static AL_INLINE int RoundDown(int iVal, int iRnd)
   return iVal & ~(iRnd - 1);
 }
 
+/***************************************************************************/
+static AL_INLINE int FindFirstSet64(uint64_t uVal)
+{
+  if(!uVal)
+    return -1;
+#if defined(__GNUC__)
+  return __builtin_ctzll(uVal);
+#else
+  int iBit = 0;
+
+  while(!(uVal & 1))
+  {
+    uVal >>= 1;
+    ++iBit;
+  }
+
+  return iBit;
+#endif
+}
+
 AL_INLINE static AL_ECodec AL_GetCodec(AL_EProfile eProf)
 {
 
@@ -2,6 +2,8 @@ LIB_COMMON_SRC:=\
 	lib_common/Utils.c\
 	lib_common/BufCommon.c\
 	lib_common/AllocatorDefault.c\
+	lib_common/AllocatorArena.c\
+	lib_common/AllocatorHugePage.c\
 	lib_common/ChannelResources.c\
 	lib_common/MemDesc.c\
 	lib_common/HwScalingList.c\
@@ -16,6 +18,7 @@ LIB_COMMON_SRC:=\
 	lib_common/StreamBuffer.c\
 	lib_common/FourCC.c\
 	lib_common/HardwareDriver.c\
+	lib_common/EventReactor.c\
 
 UNITTEST+=$(shell find lib_common/unittests -name "*.cpp")
 UNITTEST+=$(LIB_COMMON_SRC)
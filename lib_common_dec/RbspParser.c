@@ -191,6 +191,43 @@ void InitRbspParser(TCircBuffer const* pStream, uint8_t* pBuffer, bool bHasSC, A
   pRP->bHasSC = bHasSC;
 }
 
+/*****************************************************************************/
+uint64_t nal_hash(AL_TRbspParser const* pRP, uint32_t* pSize)
+{
+  // FNV-1a over the raw (still emulated) bytes of the nal, delimited the same way fetch_data does
+  uint64_t uHash = 0xCBF29CE484222325ULL;
+  uint32_t uSize = 0;
+  uint8_t uNumScDetect = pRP->uNumScDetect;
+  uint8_t uZeroBytesCount = pRP->uZeroBytesCount;
+  int32_t iOffset = pRP->iBufInOffset;
+
+  for(int32_t iAvail = pRP->iBufInAvailSize; iAvail > 0; --iAvail)
+  {
+    const uint8_t read = pRP->pBufIn[iOffset];
+    iOffset = (iOffset + 1) % pRP->iBufInSize;
+
+    if(pRP->bHasSC)
+    {
+      if((uZeroBytesCount >= 2) && (read == 0x01) && (++uNumScDetect == 2))
+        break;
+
+      uZeroBytesCount = (read == 0x00) ? uZeroBytesCount + 1 : 0;
+    }
+
+    // parameter sets bigger than the deanti-emulated buffer are not worth remembering
+    if(++uSize > NON_VCL_NAL_SIZE)
+      break;
+
+    uHash = (uHash ^ read) * 0x100000001B3ULL;
+  }
+
+  if(uSize > NON_VCL_NAL_SIZE)
+    uSize = 0;
+
+  *pSize = uSize;
+  return uSize ? (uHash | 1) : 0;
+}
+
 /*****************************************************************************/
 uint8_t read_bit(AL_TRbspParser* pRP, uint32_t iBitIndex)
 {
@@ -355,6 +392,77 @@ uint32_t offset(AL_TRbspParser* pRP)
   return pRP->iTotalBitIndex;
 }
 
+/*****************************************************************************/
+static void refill(AL_TRbspParser* pRP)
+{
+  // same refill policy as get_cache_24, so that reads past the end of a
+  // truncated nal are concealed the same way whatever the reading function
+  if((pRP->iTrailingBitOneIndex - pRP->iTotalBitIndex) < 32)
+    fetch_data(pRP);
+}
+
+/*****************************************************************************/
+static bool has_bits(AL_TRbspParser* pRP, uint32_t iNumBits)
+{
+  while(pRP->iTrailingBitOneIndex < pRP->iTotalBitIndex + iNumBits)
+    if(!fetch_data(pRP))
+      return false;
+
+  return true;
+}
+
+/*************************************************************************//*!
+   \brief Returns the next 64 bits of the bitstream, msb first, without consuming them.
+   Bits past the fetched data read as 0.
+*****************************************************************************/
+static uint64_t peek_64(AL_TRbspParser const* pRP)
+{
+  int bit_offset = (int)(pRP->iTotalBitIndex & 0x7);
+  int byte_offset = (int)(pRP->iTotalBitIndex >> 3);
+  int iNumBytes = (int)(pRP->iTrailingBitOneIndexConceal >> 3) - byte_offset;
+  uint8_t const* pBytes = &pRP->pBuffer[byte_offset];
+  uint64_t uCache = 0;
+
+#if defined(__GNUC__)
+
+  if(iNumBytes >= 8)
+  {
+    memcpy(&uCache, pBytes, sizeof(uCache));
+    return __builtin_bswap64(uCache) << bit_offset;
+  }
+#endif
+
+  for(int b = 0; b < 8; ++b)
+    uCache = (uCache << 8) | (b < iNumBytes ? pBytes[b] : 0);
+
+  return uCache << bit_offset;
+}
+
+/*****************************************************************************/
+static void consume(AL_TRbspParser* pRP, uint32_t iNumBits)
+{
+  pRP->iTotalBitIndex += iNumBits;
+  pRP->pByte = &(pRP->pBuffer[pRP->iTotalBitIndex >> 3]);
+}
+
+/*****************************************************************************/
+static uint32_t leading_zeros_64(uint64_t uVal)
+{
+#if defined(__GNUC__)
+  return __builtin_clzll(uVal);
+#else
+  uint32_t n = 0;
+
+  while(!(uVal & 0x8000000000000000ULL))
+  {
+    uVal <<= 1;
+    ++n;
+  }
+
+  return n;
+#endif
+}
+
 /*****************************************************************************/
 uint32_t u(AL_TRbspParser* pRP, uint8_t iNumBits)
 {
@@ -364,6 +472,16 @@ uint32_t u(AL_TRbspParser* pRP, uint8_t iNumBits)
   if(iNumBits == 1)
     return get_next_bit(pRP);
 
+  refill(pRP);
+
+  // the whole value is in the bit reservoir: read it at once
+  if(iNumBits && iNumBits <= 32 && has_bits(pRP, iNumBits))
+  {
+    uint64_t uCache = peek_64(pRP);
+    consume(pRP, iNumBits);
+    return (uint32_t)(uCache >> (64 - iNumBits));
+  }
+
   if(iNumBits <= 24)
   {
     uint32_t c = get_cache_24(pRP);
@@ -402,12 +520,60 @@ int32_t i(AL_TRbspParser* pRP, uint8_t iNumBits)
   return abs_val;
 }
 
+/*****************************************************************************/
+void u_flags(AL_TRbspParser* pRP, uint8_t* pFlags, int iNumFlags)
+{
+  while(iNumFlags > 0)
+  {
+    // flags already fetched are read at once, the others one by one as u(1) fetches them
+    int iNumBits = iNumFlags > 32 ? 32 : iNumFlags;
+    int iNumFetched = pRP->iTrailingBitOneIndex > pRP->iTotalBitIndex ? (int)(pRP->iTrailingBitOneIndex - pRP->iTotalBitIndex) : 0;
+
+    if(iNumBits > iNumFetched)
+      iNumBits = iNumFetched;
+
+    if(!iNumBits)
+    {
+      *pFlags++ = u(pRP, 1);
+      --iNumFlags;
+      continue;
+    }
+
+    uint64_t uCache = peek_64(pRP);
+    consume(pRP, iNumBits);
+
+    for(int b = 0; b < iNumBits; ++b)
+      pFlags[b] = (uCache >> (63 - b)) & 1;
+
+    pFlags += iNumBits;
+    iNumFlags -= iNumBits;
+  }
+}
+
 /*****************************************************************************/
 uint32_t ue(AL_TRbspParser* pRP)
 {
   if(!more_rbsp_data_conceal(pRP))
     return 0;
 
+  refill(pRP);
+  uint64_t uCache = peek_64(pRP);
+
+  // short Exp-Golomb code entirely in the bit reservoir, with enough fetched data
+  // behind it that the classic decoding below would not have fetched more either
+  if(uCache)
+  {
+    uint32_t uLeadingZeros = leading_zeros_64(uCache);
+    uint32_t uCodeEnd = pRP->iTotalBitIndex + 2 * uLeadingZeros + 1;
+
+    if(uLeadingZeros <= 22 && uCodeEnd <= pRP->iTrailingBitOneIndex &&
+       (finished_fetching(pRP) || pRP->iTrailingBitOneIndex - uCodeEnd + uLeadingZeros >= 32))
+    {
+      consume(pRP, 2 * uLeadingZeros + 1);
+      return (uint32_t)(uCache >> (63 - 2 * uLeadingZeros)) - 1;
+    }
+  }
+
   uint32_t c = get_cache_24(pRP);
   int n = 23 - al_log2(c);
 
@@ -79,6 +79,15 @@ typedef struct t_RbspParser
 *****************************************************************************/
 void InitRbspParser(TCircBuffer const* pStream, uint8_t* pBuffer, bool bHasSC, AL_TRbspParser* pRP);
 
+/*************************************************************************//*!
+   \brief The nal_hash function computes a content hash of the raw bytes of the
+   current NAL unit without consuming them
+   \param[in]  pRP   Pointer to NAL parser
+   \param[out] pSize Receives the number of bytes hashed, 0 if the NAL is too big to be hashed
+   \return    return the hash of the NAL unit, never 0 unless *pSize is 0
+*****************************************************************************/
+uint64_t nal_hash(AL_TRbspParser const* pRP, uint32_t* pSize);
+
 /*************************************************************************//*!
    \brief The read_bit function read the bit_index'th bit of the current NAL
    \param[in] pRP       Pointer to NAL parser
@@ -167,6 +176,11 @@ uint32_t u(AL_TRbspParser* pRP, uint8_t iNumBits);
 *****************************************************************************/
 int32_t i(AL_TRbspParser* pRP, uint8_t iNumBits);
 
+/*************************************************************************//*!
+   \brief Reads iNumFlags consecutive 1 bit flags from bit buffer into pFlags.
+*****************************************************************************/
+void u_flags(AL_TRbspParser* pRP, uint8_t* pFlags, int iNumFlags);
+
 /*************************************************************************//*!
    \brief Reads an unsigned exp-golomb value from bit buffer and returns its value.
 *****************************************************************************/
@@ -258,7 +258,7 @@ static bool initChannel(AL_TDecCtx* pCtx, AL_TAvcSps const* pSPS)
   }
 
   AL_CB_EndFrameDecoding endFrameDecodingCallback = { AL_Default_Decoder_EndDecoding, pCtx };
-  AL_ERR eError = AL_IDecChannel_Configure(pCtx->pDecChannel, &pCtx->chanParam, endFrameDecodingCallback);
+  AL_ERR eError = AL_IDecChannel_Configure(pCtx->pDecChannel, &pCtx->chanParam, endFrameDecodingCallback, &pCtx->tCallbackThread);
 
   if(eError != AL_SUCCESS)
   {
@@ -759,6 +759,10 @@ void AL_AVC_InitAUP(AL_TAvcAup* pAUP)
   for(int i = 0; i < AL_AVC_MAX_SPS; ++i)
     pAUP->pSPS[i].bConceal = true;
 
+  AL_ParamSetMemo_Init(&pAUP->SpsIndex, pAUP->pSpsMemo, AL_AVC_MAX_SPS);
+  AL_ParamSetMemo_Init(&pAUP->PpsIndex, pAUP->pPpsMemo, AL_AVC_MAX_PPS);
+  pAUP->uSpsGeneration = 0;
+
   pAUP->ePictureType = SLICE_I;
   pAUP->pActiveSPS = NULL;
 }
@@ -102,25 +102,28 @@ void AL_BufferFeeder_Destroy(AL_TBufferFeeder* this)
   AL_DecoderFeeder_Destroy(this->decoderFeeder);
   AL_Patchworker_Deinit(&this->patchworker);
   AL_Fifo_Deinit(&this->fifo);
-  Rtos_Free(this);
+  AL_Allocator_Free(this->pAllocator, this->hThis);
 }
 
-AL_TBufferFeeder* AL_BufferFeeder_Create(AL_HANDLE hDec, TCircBuffer* circularBuf, int iMaxBufNum, AL_CB_Error* errorCallback)
+AL_TBufferFeeder* AL_BufferFeeder_Create(AL_HANDLE hDec, TCircBuffer* circularBuf, int iMaxBufNum, AL_CB_Error* errorCallback, AL_TAllocator* pAllocator, AL_TThreadAttr const* pThreadAttr)
 {
-  AL_TBufferFeeder* this = Rtos_Malloc(sizeof(*this));
+  AL_HANDLE hThis = AL_Allocator_Alloc(pAllocator, sizeof(AL_TBufferFeeder));
 
-  if(!this)
+  if(!hThis)
     return NULL;
 
+  AL_TBufferFeeder* this = (AL_TBufferFeeder*)AL_Allocator_GetVirtualAddr(pAllocator, hThis);
+  this->pAllocator = pAllocator;
+  this->hThis = hThis;
   this->eosBuffer = NULL;
 
-  if(iMaxBufNum <= 0 || !AL_Fifo_Init(&this->fifo, iMaxBufNum))
+  if(iMaxBufNum <= 0 || !AL_Fifo_InitWithAllocator(&this->fifo, iMaxBufNum, pAllocator))
     goto fail_queue_allocation;
 
   if(!AL_Patchworker_Init(&this->patchworker, circularBuf, &this->fifo))
     goto fail_patchworker_allocation;
 
-  this->decoderFeeder = AL_DecoderFeeder_Create(&circularBuf->tMD, hDec, &this->patchworker, errorCallback);
+  this->decoderFeeder = AL_DecoderFeeder_Create(&circularBuf->tMD, hDec, &this->patchworker, errorCallback, pAllocator, pThreadAttr);
 
   if(!this->decoderFeeder)
     goto fail_decoder_feeder_creation;
@@ -132,7 +135,7 @@ AL_TBufferFeeder* AL_BufferFeeder_Create(AL_HANDLE hDec, TCircBuffer* circularBu
   fail_patchworker_allocation:
   AL_Fifo_Deinit(&this->fifo);
   fail_queue_allocation:
-  Rtos_Free(this);
+  AL_Allocator_Free(pAllocator, hThis);
   return NULL;
 }
 
@@ -46,6 +46,8 @@
 
 typedef struct al_t_BufferFeeder
 {
+  AL_TAllocator* pAllocator;
+  AL_HANDLE hThis;
   AL_TFifo fifo;
   AL_TPatchworker patchworker;
   AL_TDecoderFeeder* decoderFeeder;
@@ -53,7 +55,7 @@ typedef struct al_t_BufferFeeder
   AL_TBuffer* eosBuffer;
 }AL_TBufferFeeder;
 
-AL_TBufferFeeder* AL_BufferFeeder_Create(AL_HANDLE hDec, TCircBuffer* circularBuf, int uMaxBufNum, AL_CB_Error* errorCallback);
+AL_TBufferFeeder* AL_BufferFeeder_Create(AL_HANDLE hDec, TCircBuffer* circularBuf, int uMaxBufNum, AL_CB_Error* errorCallback, AL_TAllocator* pAllocator, AL_TThreadAttr const* pThreadAttr);
 void AL_BufferFeeder_Destroy(AL_TBufferFeeder* pFeeder);
 /* push a buffer in the queue. it will be fed to the decoder when possible */
 bool AL_BufferFeeder_PushBuffer(AL_TBufferFeeder* pFeeder, AL_TBuffer* pBuf, size_t uSize, bool bLastBuffer);
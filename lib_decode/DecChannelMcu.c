@@ -37,16 +37,18 @@
 
 #include "lib_decode/I_DecChannel.h"
 #include "lib_common/IDriver.h"
+#include "lib_common/EventReactor.h"
+#include "lib_decode/DecChannelMcu.h"
 
 #if  __linux__
 
-#include <pthread.h>
 #include <stdio.h>
 #include <string.h> // strerrno
 #include <errno.h>
 #include <assert.h>
 
 #include "allegro_ioctl_mcu_dec.h"
+#include "lib_decode/EventQueue.h"
 #include "lib_common/List.h"
 #include "lib_common/Error.h"
 
@@ -54,46 +56,12 @@
 
 static const char* deviceFile = "/dev/allegroDecodeIP";
 
-typedef struct
-{
-  pthread_cond_t Cond;
-  pthread_mutex_t Lock;
-}AL_WaitQueue;
-
-static void AL_WakeUp(AL_WaitQueue* pQueue)
-{
-  pthread_mutex_lock(&pQueue->Lock);
-  int ret = pthread_cond_broadcast(&pQueue->Cond);
-  assert(ret == 0);
-  pthread_mutex_unlock(&pQueue->Lock);
-}
-
-static void AL_WaitEvent(AL_WaitQueue* pQueue, bool (* isReady)(void*), void* pParam)
-{
-  pthread_mutex_lock(&pQueue->Lock);
-
-  while(!isReady(pParam))
-    pthread_cond_wait(&pQueue->Cond, &pQueue->Lock);
-
-  pthread_mutex_unlock(&pQueue->Lock);
-}
-
-static void AL_WaitQueue_Init(AL_WaitQueue* pQueue)
-{
-  pthread_mutex_init(&pQueue->Lock, NULL);
-  pthread_cond_init(&pQueue->Cond, NULL);
-}
-
-static void AL_WaitQueue_Deinit(AL_WaitQueue* pQueue)
-{
-  pthread_mutex_destroy(&pQueue->Lock);
-  pthread_cond_destroy(&pQueue->Cond);
-}
-
 typedef struct
 {
   int fd;
   AL_THREAD thread;
+  AL_TEventReactor* reactor;
+  AL_TEventSource* statusSource;
   bool bBeingDestroyed;
   AL_TDriver* driver;
 
@@ -102,25 +70,13 @@ typedef struct
 
 typedef struct
 {
+  AL_QueueNode Node;
   int fd;
   AL_CB_EndStartCode endStartCodeCB;
   bool bEnded;
   AL_TDriver* driver;
 }SCMsg;
 
-typedef struct AL_t_Event
-{
-  void* pPriv;
-  AL_ListHead List;
-}AL_Event;
-
-typedef struct AL_t_EventQueue
-{
-  AL_WaitQueue Queue;
-  AL_ListHead List;
-  pthread_mutex_t Lock;
-}AL_EventQueue;
-
 typedef struct
 {
   AL_EventQueue EventQueue;
@@ -134,42 +90,9 @@ struct DecChanMcuCtx
   Channel chan;
   bool chanIsConfigured;
   AL_TDriver* driver;
+  AL_TEventReactor* reactor;
 };
 
-static void AL_EventQueue_Init(AL_EventQueue* pEventQueue)
-{
-  AL_WaitQueue_Init(&pEventQueue->Queue);
-  AL_ListHeadInit(&pEventQueue->List);
-  pthread_mutex_init(&pEventQueue->Lock, NULL);
-}
-
-static void AL_EventQueue_Deinit(AL_EventQueue* pEventQueue)
-{
-  pthread_mutex_destroy(&pEventQueue->Lock);
-  AL_WaitQueue_Deinit(&pEventQueue->Queue);
-}
-
-static void AL_EventQueue_Push(AL_EventQueue* pEventQueue, AL_Event* pEvent)
-{
-  pthread_mutex_lock(&pEventQueue->Lock);
-  AL_ListAddTail(&pEvent->List, &pEventQueue->List);
-  pthread_mutex_unlock(&pEventQueue->Lock);
-
-  AL_WakeUp(&pEventQueue->Queue);
-}
-
-/* for one Reader */
-static void AL_EventQueue_Fetch(AL_EventQueue* EventQueue, AL_Event** pEvent, bool (* isReady)(void*), void* pParam)
-{
-  AL_WaitEvent(&EventQueue->Queue, isReady, pParam);
-
-  /* get msg */
-  pthread_mutex_lock(&EventQueue->Lock);
-  *pEvent = AL_ListFirstEntry(&EventQueue->List, AL_Event, List);
-  AL_ListDel(&(*pEvent)->List);
-  pthread_mutex_unlock(&EventQueue->Lock);
-}
-
 void setPictParam(struct al5_params* msg, AL_TDecPicParam* pPictParam)
 {
   static_assert(sizeof(*pPictParam) <= sizeof(msg->opaque), "Driver pict_param struct is too small");
@@ -215,10 +138,9 @@ static void processStatusMsg(Channel* chan, struct al5_params* msg)
   chan->endFrameDecodingCB.func(chan->endFrameDecodingCB.userParam, &status);
 }
 
-static void* NotificationThread(void* p)
+/* Process the statuses until the channel is destroyed */
+static void processStatusMsgsUntilEnd(Channel* chan)
 {
-  Channel* chan = p;
-
   for(;;)
   {
     struct al5_params msg = { 0 };
@@ -228,10 +150,26 @@ static void* NotificationThread(void* p)
 
     processStatusMsg(chan, &msg);
   }
+}
 
+static void* NotificationThread(void* p)
+{
+  processStatusMsgsUntilEnd(p);
   return NULL;
 }
 
+static bool OnStatusReady(void* p)
+{
+  Channel* chan = p;
+  struct al5_params msg = { 0 };
+
+  if(!getStatusMsg(chan, &msg))
+    return false;
+
+  processStatusMsg(chan, &msg);
+  return true;
+}
+
 static void setScStatus(AL_TScStatus* status, struct al5_scstatus* msg)
 {
   status->uNumSC = msg->num_sc;
@@ -246,13 +184,6 @@ static void processScStatusMsg(SCMsg* pMsg, struct al5_scstatus* StatusMsg)
   pMsg->endStartCodeCB.func(pMsg->endStartCodeCB.userParam, &status);
 }
 
-/* One reader, no race condition */
-bool isSCReady(void* p)
-{
-  AL_EventQueue* pCtx = p;
-  return !AL_ListEmpty(&pCtx->List);
-}
-
 static void* ScNotificationThread(void* p)
 {
   StartCodeEventQueue* pSCQueue = p;
@@ -261,10 +192,7 @@ static void* ScNotificationThread(void* p)
 
   while(true)
   {
-    AL_Event* pEvent;
-    AL_EventQueue_Fetch(pEventQueue, &pEvent, isSCReady, pEventQueue);
-    SCMsg* pMsg = pEvent->pPriv;
-    Rtos_Free(pEvent);
+    SCMsg* pMsg = containerOf(AL_EventQueue_Fetch(pEventQueue), SCMsg, Node);
 
     if(pMsg->bEnded)
     {
@@ -315,12 +243,26 @@ static void DecChannelMcu_DestroyChannel(Channel* chan)
 {
   chan->bBeingDestroyed = true;
 
-  if(AL_Driver_PostMessage(chan->driver, chan->fd, AL_MCU_DESTROY_CHANNEL, NULL) != DRIVER_SUCCESS)
+  bool bDestroyed = AL_Driver_PostMessage(chan->driver, chan->fd, AL_MCU_DESTROY_CHANNEL, NULL) == DRIVER_SUCCESS;
+
+  /* the fd is about to be closed, it can't stay in the reactor. As for the
+   * status thread, the destruction wakes up a callback waiting for a status */
+  if(chan->reactor)
+    AL_EventReactor_Remove(chan->reactor, chan->statusSource);
+
+  if(!bDestroyed)
   {
     perror("Failed to destroy channel");
     goto exit;
   }
 
+  /* the statuses still queued are processed here, as the thread would do */
+  if(chan->reactor)
+  {
+    processStatusMsgsUntilEnd(chan);
+    goto exit;
+  }
+
   Rtos_JoinThread(chan->thread);
   Rtos_DeleteThread(chan->thread);
 
@@ -333,10 +275,6 @@ static void DecChannelMcu_Destroy(AL_TIDecChannel* pDecChannel)
   struct DecChanMcuCtx* decChanMcu = (struct DecChanMcuCtx*)pDecChannel;
   StartCodeEventQueue* SCQueue = &decChanMcu->SCQueue;
 
-  AL_Event* pEvent = Rtos_Malloc(sizeof(*pEvent));
-
-  if(!pEvent)
-    goto fail_event;
   SCMsg* pMsg = Rtos_Malloc(sizeof(*pMsg));
 
   if(!pMsg)
@@ -344,8 +282,7 @@ static void DecChannelMcu_Destroy(AL_TIDecChannel* pDecChannel)
 
   pMsg->bEnded = true;
   pMsg->driver = decChanMcu->driver;
-  pEvent->pPriv = pMsg;
-  AL_EventQueue_Push(&SCQueue->EventQueue, pEvent);
+  AL_EventQueue_Push(&SCQueue->EventQueue, &pMsg->Node);
 
   if(decChanMcu->chanIsConfigured)
     DecChannelMcu_DestroyChannel(&decChanMcu->chan);
@@ -364,12 +301,10 @@ static void DecChannelMcu_Destroy(AL_TIDecChannel* pDecChannel)
   fail_join:
   AL_EventQueue_Deinit(&SCQueue->EventQueue);
   fail_msg:
-  Rtos_Free(pEvent);
-  fail_event:
   return;
 }
 
-static AL_ERR DecChannelMcu_ConfigChannel(AL_TIDecChannel* pDecChannel, AL_TDecChanParam* pChParam, AL_CB_EndFrameDecoding callback)
+static AL_ERR DecChannelMcu_ConfigChannel(AL_TIDecChannel* pDecChannel, AL_TDecChanParam* pChParam, AL_CB_EndFrameDecoding callback, AL_TThreadAttr const* pThreadAttr)
 {
   struct DecChanMcuCtx* decChanMcu = (struct DecChanMcuCtx*)pDecChannel;
   AL_ERR errorCode = AL_ERROR;
@@ -379,6 +314,7 @@ static AL_ERR DecChannelMcu_ConfigChannel(AL_TIDecChannel* pDecChannel, AL_TDecC
   chan->bBeingDestroyed = false;
   chan->endFrameDecodingCB = callback;
   chan->driver = decChanMcu->driver;
+  chan->reactor = decChanMcu->reactor;
   chan->fd = AL_Driver_Open(chan->driver, deviceFile);
 
   if(chan->fd < 0)
@@ -408,10 +344,30 @@ static AL_ERR DecChannelMcu_ConfigChannel(AL_TIDecChannel* pDecChannel, AL_TDecC
 
   getParamUpdateByMcu(&msg.status, pChParam);
 
-  chan->thread = Rtos_CreateThread(&NotificationThread, chan);
+  if(chan->reactor)
+  {
+    chan->statusSource = AL_EventReactor_Add(chan->reactor, chan->fd, &OnStatusReady, chan);
+
+    /* the driver can't be polled, wait for the statuses in a thread instead */
+    if(!chan->statusSource)
+      chan->reactor = NULL;
+  }
 
-  if(!chan->thread)
-    goto fail_open;
+  if(!chan->reactor)
+  {
+    AL_TThreadAttr threadAttr = { 0 };
+
+    if(pThreadAttr)
+      threadAttr = *pThreadAttr;
+
+    if(!threadAttr.pName)
+      threadAttr.pName = "al_dec_status";
+
+    chan->thread = Rtos_CreateThreadWithAttr(&NotificationThread, chan, &threadAttr);
+
+    if(!chan->thread)
+      goto fail_open;
+  }
 
   decChanMcu->chanIsConfigured = true;
   return AL_SUCCESS;
@@ -447,11 +403,6 @@ static void DecChannelMcu_SearchSC(AL_TIDecChannel* pDecChannel, AL_TScParam* pS
 {
   struct DecChanMcuCtx* decChanMcu = (struct DecChanMcuCtx*)pDecChannel;
   AL_EventQueue* pEventQueue = &decChanMcu->SCQueue.EventQueue;
-  AL_Event* pEvent = Rtos_Malloc(sizeof(*pEvent));
-
-  if(!pEvent)
-    goto fail_event;
-
   SCMsg* pMsg = Rtos_Malloc(sizeof(*pMsg));
 
   if(!pMsg)
@@ -477,8 +428,7 @@ static void DecChannelMcu_SearchSC(AL_TIDecChannel* pDecChannel, AL_TScParam* pS
     goto fail_open;
   }
 
-  pEvent->pPriv = pMsg;
-  AL_EventQueue_Push(pEventQueue, pEvent);
+  AL_EventQueue_Push(pEventQueue, &pMsg->Node);
 
   return;
 
@@ -486,8 +436,6 @@ static void DecChannelMcu_SearchSC(AL_TIDecChannel* pDecChannel, AL_TScParam* pS
   AL_Driver_Close(pMsg->driver, pMsg->fd);
   Rtos_Free(pMsg);
   fail_msg:
-  Rtos_Free(pEvent);
-  fail_event:
   return;
 }
 
@@ -542,13 +490,14 @@ static const AL_TIDecChannelVtable DecChannelMcu =
   DecChannelMcu_DecodeOneSlice,
 };
 
-AL_TIDecChannel* AL_DecChannelMcu_Create(AL_TDriver* driver)
+AL_TIDecChannel* AL_DecChannelMcu_CreateWithReactor(AL_TDriver* driver, AL_TEventReactor* pReactor)
 {
   struct DecChanMcuCtx* decChannel = Rtos_Malloc(sizeof(*decChannel));
 
   if(!decChannel)
     return NULL;
   decChannel->vtable = &DecChannelMcu;
+  decChannel->reactor = pReactor;
 
   if(!DecChannelMcu_Init(decChannel))
   {
@@ -561,8 +510,19 @@ AL_TIDecChannel* AL_DecChannelMcu_Create(AL_TDriver* driver)
   return (AL_TIDecChannel*)decChannel;
 }
 
+AL_TIDecChannel* AL_DecChannelMcu_Create(AL_TDriver* driver)
+{
+  return AL_DecChannelMcu_CreateWithReactor(driver, NULL);
+}
+
 #else
 
+AL_TIDecChannel* AL_DecChannelMcu_CreateWithReactor(AL_TDriver* driver, AL_TEventReactor* pReactor)
+{
+  (void)driver, (void)pReactor;
+  return NULL;
+}
+
 AL_TIDecChannel* AL_DecChannelMcu_Create(AL_TDriver* driver)
 {
   (void)driver;
@@ -50,6 +50,8 @@ void AL_Decoder_FlushInput(AL_HDecoder hDec);
 
 typedef struct AL_TDecoderFeederS
 {
+  AL_TAllocator* pAllocator;
+  AL_HANDLE hThis;
   AL_HANDLE hDec;
   AL_TPatchworker* patchworker;
   /* set when the slave thread might have work to do */
@@ -164,9 +166,17 @@ static void Slave_EntryPoint(AL_TDecoderFeeder* slave)
   }
 }
 
-static bool CreateSlave(AL_TDecoderFeeder* this)
+static bool CreateSlave(AL_TDecoderFeeder* this, AL_TThreadAttr const* pThreadAttr)
 {
-  this->slave = Rtos_CreateThread((void*)&Slave_EntryPoint, this);
+  AL_TThreadAttr threadAttr = { 0 };
+
+  if(pThreadAttr)
+    threadAttr = *pThreadAttr;
+
+  if(!threadAttr.pName)
+    threadAttr.pName = "al_dec_feeder";
+
+  this->slave = Rtos_CreateThreadWithAttr((void*)&Slave_EntryPoint, this, &threadAttr);
 
   if(!this->slave)
     return false;
@@ -191,7 +201,7 @@ void AL_DecoderFeeder_Destroy(AL_TDecoderFeeder* this)
     return;
   DestroySlave(this);
   Rtos_DeleteEvent(this->incomingWorkEvent);
-  Rtos_Free(this);
+  AL_Allocator_Free(this->pAllocator, this->hThis);
 }
 
 void AL_DecoderFeeder_Process(AL_TDecoderFeeder* this)
@@ -211,13 +221,17 @@ void AL_DecoderFeeder_Reset(AL_TDecoderFeeder* this)
   CircBuffer_Init(&this->startCodeStreamView);
 }
 
-AL_TDecoderFeeder* AL_DecoderFeeder_Create(TMemDesc* streamMemory, AL_HANDLE hDec, AL_TPatchworker* patchworker, AL_CB_Error* errorCallback)
+AL_TDecoderFeeder* AL_DecoderFeeder_Create(TMemDesc* streamMemory, AL_HANDLE hDec, AL_TPatchworker* patchworker, AL_CB_Error* errorCallback, AL_TAllocator* pAllocator, AL_TThreadAttr const* pThreadAttr)
 {
-  AL_TDecoderFeeder* this = Rtos_Malloc(sizeof(*this));
+  AL_HANDLE hThis = AL_Allocator_Alloc(pAllocator, sizeof(AL_TDecoderFeeder));
 
-  if(!this)
+  if(!hThis)
     return NULL;
 
+  AL_TDecoderFeeder* this = (AL_TDecoderFeeder*)AL_Allocator_GetVirtualAddr(pAllocator, hThis);
+  this->pAllocator = pAllocator;
+  this->hThis = hThis;
+
   if(!patchworker)
     goto cleanup;
 
@@ -237,14 +251,14 @@ AL_TDecoderFeeder* AL_DecoderFeeder_Create(TMemDesc* streamMemory, AL_HANDLE hDe
   this->endWithAccessUnit = true;
   this->hDec = hDec;
 
-  if(!CreateSlave(this))
+  if(!CreateSlave(this, pThreadAttr))
     goto cleanup;
 
   return this;
 
   cleanup:
   Rtos_DeleteEvent(this->incomingWorkEvent);
-  Rtos_Free(this);
+  AL_Allocator_Free(pAllocator, hThis);
   return NULL;
 }
 
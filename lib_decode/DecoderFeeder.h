@@ -52,7 +52,7 @@ typedef struct
 
 typedef struct AL_TDecoderFeederS AL_TDecoderFeeder;
 
-AL_TDecoderFeeder* AL_DecoderFeeder_Create(TMemDesc* decodeMemoryDescriptor, AL_HANDLE hDec, AL_TPatchworker* patchworker, AL_CB_Error* errorCallback);
+AL_TDecoderFeeder* AL_DecoderFeeder_Create(TMemDesc* decodeMemoryDescriptor, AL_HANDLE hDec, AL_TPatchworker* patchworker, AL_CB_Error* errorCallback, AL_TAllocator* pAllocator, AL_TThreadAttr const* pThreadAttr);
 void AL_DecoderFeeder_Destroy(AL_TDecoderFeeder* pDecFeeder);
 /* push a buffer in the queue. it will be fed to the decoder when possible */
 void AL_DecoderFeeder_Process(AL_TDecoderFeeder* pDecFeeder);
@@ -64,6 +64,9 @@
 #define AVC_NAL_HDR_SIZE 4
 #define HEVC_NAL_HDR_SIZE 5
 
+/* the decoder context, the deanti-emulated buffer and the input feeder fit in the first chunk */
+#define DEC_ARENA_CHUNK_SIZE (sizeof(AL_TDefaultDecoder) + NON_VCL_NAL_SIZE + 16 * 1024)
+
 /*****************************************************************************/
 static bool isAVC(AL_ECodec eCodec)
 {
@@ -354,14 +357,14 @@ void AL_Default_Decoder_Destroy(AL_TDecoder* pAbsDec)
   AL_IDecChannel_Destroy(pCtx->pDecChannel);
   DeinitPictureManager(pCtx);
   MemDesc_Free(&pCtx->circularBuf.tMD);
-  Rtos_Free(pCtx->BufNoAE.tMD.pVirtualAddr);
   DeinitBuffers(pCtx);
 
   Rtos_DeleteSemaphore(pCtx->Sem);
   Rtos_DeleteEvent(pCtx->ScDetectionComplete);
   Rtos_DeleteMutex(pCtx->DecMutex);
 
-  Rtos_Free(pDec);
+  /* pDec itself lives in the arena */
+  AL_Allocator_Destroy(pCtx->pArena);
 }
 
 /*****************************************************************************/
@@ -1074,6 +1077,7 @@ static void AssignSettings(AL_TDecCtx* const pCtx, AL_TDecSettings const* const
   pCtx->eDpbMode = pSettings->eDpbMode;
   pCtx->tStreamSettings = pSettings->tStream;
   pCtx->bUseIFramesAsSyncPoint = pSettings->bUseIFramesAsSyncPoint;
+  pCtx->tCallbackThread = pSettings->tCallbackThread;
 
   AL_TDecChanParam* pChan = &pCtx->chanParam;
   pChan->uMaxLatency = pSettings->iStackSize;
@@ -1215,12 +1219,21 @@ AL_ERR AL_CreateDefaultDecoder(AL_TDecoder** hDec, AL_TIDecChannel* pDecChannel,
   if(!CheckCallBacks(pCB))
     return AL_ERR_REQUEST_MALFORMED;
 
-  AL_TDefaultDecoder* const pDec = (AL_TDefaultDecoder*)Rtos_Malloc(sizeof(AL_TDefaultDecoder));
+  AL_TAllocator* const pArena = AL_ArenaAllocator_Create(DEC_ARENA_CHUNK_SIZE);
+
+  if(!pArena)
+    return AL_ERR_NO_MEMORY;
+
+  AL_HANDLE const hDecoder = AL_Allocator_Alloc(pArena, sizeof(AL_TDefaultDecoder));
   AL_ERR errorCode = AL_ERROR;
 
-  if(!pDec)
+  if(!hDecoder)
+  {
+    AL_Allocator_Destroy(pArena);
     return AL_ERR_NO_MEMORY;
+  }
 
+  AL_TDefaultDecoder* const pDec = (AL_TDefaultDecoder*)AL_Allocator_GetVirtualAddr(pArena, hDecoder);
   Rtos_Memset(pDec, 0, sizeof(*pDec));
 
   pDec->vtable = &AL_Default_Decoder_Vtable;
@@ -1228,6 +1241,7 @@ AL_ERR AL_CreateDefaultDecoder(AL_TDecoder** hDec, AL_TIDecChannel* pDecChannel,
 
   pCtx->pDecChannel = pDecChannel;
   pCtx->pAllocator = pAllocator;
+  pCtx->pArena = pArena;
 
   InitInternalBuffers(pCtx);
 
@@ -1304,12 +1318,14 @@ AL_ERR AL_CreateDefaultDecoder(AL_TDecoder** hDec, AL_TIDecChannel* pDecChannel,
 
 
   // Alloc Decoder Deanti-emulated buffer for high level syntax parsing
-  pCtx->BufNoAE.tMD.pVirtualAddr = Rtos_Malloc(NON_VCL_NAL_SIZE);
-  pCtx->BufNoAE.tMD.uSize = NON_VCL_NAL_SIZE;
+  AL_HANDLE const hBufNoAE = AL_Allocator_Alloc(pArena, NON_VCL_NAL_SIZE);
 
-  if(!pCtx->BufNoAE.tMD.pVirtualAddr)
+  if(!hBufNoAE)
     goto cleanup;
 
+  pCtx->BufNoAE.tMD.pVirtualAddr = AL_Allocator_GetVirtualAddr(pArena, hBufNoAE);
+  pCtx->BufNoAE.tMD.uSize = NON_VCL_NAL_SIZE;
+
   pCtx->eosBuffer = isAVC(pCtx->chanParam.eCodec) ? AllocEosBufferAVC() : AllocEosBufferHEVC();
 
   if(!pCtx->eosBuffer)
@@ -1328,7 +1344,7 @@ AL_ERR AL_CreateDefaultDecoder(AL_TDecoder** hDec, AL_TIDecChannel* pDecChannel,
   if(!MemDesc_AllocNamed(&pCtx->circularBuf.tMD, pAllocator, iBufferStreamSize, "circular stream"))
     goto cleanup;
 
-  pCtx->Feeder = AL_BufferFeeder_Create((AL_HDecoder)pDec, &pCtx->circularBuf, iInputFifoSize, &errorCallback);
+  pCtx->Feeder = AL_BufferFeeder_Create((AL_HDecoder)pDec, &pCtx->circularBuf, iInputFifoSize, &errorCallback, pArena, &pCtx->tCallbackThread);
 
   if(!pCtx->Feeder)
     goto cleanup;
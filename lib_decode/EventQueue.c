@@ -0,0 +1,141 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#include "lib_decode/EventQueue.h"
+
+#if __linux__
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*****************************************************************************/
+void AL_EventQueue_Init(AL_EventQueue* pEventQueue)
+{
+  pEventQueue->Stub.pNext = NULL;
+  pEventQueue->pHead = &pEventQueue->Stub;
+  pEventQueue->pTail = &pEventQueue->Stub;
+  pEventQueue->iWaiting = 0;
+}
+
+/*****************************************************************************/
+void AL_EventQueue_Deinit(AL_EventQueue* pEventQueue)
+{
+  (void)pEventQueue;
+}
+
+/*****************************************************************************/
+static void AL_EventQueue_Enqueue(AL_EventQueue* pEventQueue, AL_QueueNode* pNode)
+{
+  __atomic_store_n(&pNode->pNext, NULL, __ATOMIC_RELAXED);
+  AL_QueueNode* pPrev = __atomic_exchange_n(&pEventQueue->pHead, pNode, __ATOMIC_ACQ_REL);
+  /* until this store, the consumer sees the queue as empty after pPrev */
+  __atomic_store_n(&pPrev->pNext, pNode, __ATOMIC_RELEASE);
+}
+
+/*****************************************************************************/
+void AL_EventQueue_Push(AL_EventQueue* pEventQueue, AL_QueueNode* pNode)
+{
+  AL_EventQueue_Enqueue(pEventQueue, pNode);
+
+  if(__atomic_exchange_n(&pEventQueue->iWaiting, 0, __ATOMIC_SEQ_CST))
+    syscall(SYS_futex, &pEventQueue->iWaiting, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/*****************************************************************************/
+AL_QueueNode* AL_EventQueue_TryPop(AL_EventQueue* pEventQueue)
+{
+  AL_QueueNode* pTail = pEventQueue->pTail;
+  AL_QueueNode* pNext = __atomic_load_n(&pTail->pNext, __ATOMIC_ACQUIRE);
+
+  if(pTail == &pEventQueue->Stub)
+  {
+    if(!pNext)
+      return NULL;
+    pEventQueue->pTail = pNext;
+    pTail = pNext;
+    pNext = __atomic_load_n(&pNext->pNext, __ATOMIC_ACQUIRE);
+  }
+
+  if(pNext)
+  {
+    pEventQueue->pTail = pNext;
+    return pTail;
+  }
+
+  if(pTail != __atomic_load_n(&pEventQueue->pHead, __ATOMIC_ACQUIRE))
+    return NULL;
+
+  /* pTail is the last node: put the stub behind it so that it can be popped */
+  AL_EventQueue_Enqueue(pEventQueue, &pEventQueue->Stub);
+  pNext = __atomic_load_n(&pTail->pNext, __ATOMIC_ACQUIRE);
+
+  if(pNext)
+  {
+    pEventQueue->pTail = pNext;
+    return pTail;
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+AL_QueueNode* AL_EventQueue_Fetch(AL_EventQueue* pEventQueue)
+{
+  while(true)
+  {
+    AL_QueueNode* pNode = AL_EventQueue_TryPop(pEventQueue);
+
+    if(pNode)
+      return pNode;
+
+    __atomic_store_n(&pEventQueue->iWaiting, 1, __ATOMIC_SEQ_CST);
+
+    /* a push that completed before iWaiting was set didn't wake us up */
+    pNode = AL_EventQueue_TryPop(pEventQueue);
+
+    if(pNode)
+    {
+      __atomic_store_n(&pEventQueue->iWaiting, 0, __ATOMIC_RELAXED);
+      return pNode;
+    }
+
+    syscall(SYS_futex, &pEventQueue->iWaiting, FUTEX_WAIT_PRIVATE, 1, NULL, NULL, 0);
+  }
+}
+
+#endif
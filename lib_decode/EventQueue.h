@@ -0,0 +1,70 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#pragma once
+
+#include "lib_rtos/types.h"
+
+typedef struct AL_t_QueueNode
+{
+  struct AL_t_QueueNode* pNext;
+}AL_QueueNode;
+
+/* Intrusive multi-producer single-consumer queue (Vyukov).
+ * Pushing never blocks. The consumer sleeps on a futex when the queue is
+ * empty, and only then does a producer make a syscall to wake it up.
+ * Linux only */
+typedef struct AL_t_EventQueue
+{
+  AL_QueueNode* pHead; /* last pushed node, shared by the producers */
+  AL_QueueNode* pTail; /* next node to pop, owned by the consumer */
+  AL_QueueNode Stub;
+  int32_t iWaiting; /* futex word, 1 when the consumer is going to sleep */
+}AL_EventQueue;
+
+void AL_EventQueue_Init(AL_EventQueue* pEventQueue);
+void AL_EventQueue_Deinit(AL_EventQueue* pEventQueue);
+
+/* for any number of writers, never blocks */
+void AL_EventQueue_Push(AL_EventQueue* pEventQueue, AL_QueueNode* pNode);
+
+/* for one Reader. Returns NULL if the queue is empty or if a producer is
+ * in the middle of a push */
+AL_QueueNode* AL_EventQueue_TryPop(AL_EventQueue* pEventQueue);
+
+/* for one Reader, waits until a node is pushed */
+AL_QueueNode* AL_EventQueue_Fetch(AL_EventQueue* pEventQueue);
@@ -352,7 +352,7 @@ static bool initChannel(AL_TDecCtx* pCtx, AL_THevcSps const* pSPS)
   }
 
   AL_CB_EndFrameDecoding endFrameDecodingCallback = { AL_Default_Decoder_EndDecoding, pCtx };
-  AL_ERR eError = AL_IDecChannel_Configure(pCtx->pDecChannel, &pCtx->chanParam, endFrameDecodingCallback);
+  AL_ERR eError = AL_IDecChannel_Configure(pCtx->pDecChannel, &pCtx->chanParam, endFrameDecodingCallback, &pCtx->tCallbackThread);
 
   if(eError != AL_SUCCESS)
   {
@@ -898,6 +898,11 @@ void AL_HEVC_InitAUP(AL_THevcAup* pAUP)
   for(int i = 0; i < AL_HEVC_MAX_SPS; ++i)
     pAUP->pSPS[i].bConceal = true;
 
+  AL_ParamSetMemo_Init(&pAUP->PpsIndex, pAUP->pPpsMemo, AL_HEVC_MAX_PPS);
+  AL_ParamSetMemo_Init(&pAUP->SpsIndex, pAUP->pSpsMemo, AL_HEVC_MAX_SPS);
+  AL_ParamSetMemo_Init(&pAUP->VpsIndex, pAUP->pVpsMemo, AL_MAX_VPS);
+  pAUP->uSpsGeneration = 0;
+
   pAUP->pActiveSPS = NULL;
 }
 
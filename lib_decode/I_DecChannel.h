@@ -88,7 +88,7 @@ typedef struct AL_t_IDecChannel
 typedef struct AL_t_IDecChannelVtable
 {
   void (* Destroy)(AL_TIDecChannel* pDecChannel);
-  AL_ERR (* Configure)(AL_TIDecChannel* pDecChannel, AL_TDecChanParam* pChParam, AL_CB_EndFrameDecoding callback);
+  AL_ERR (* Configure)(AL_TIDecChannel* pDecChannel, AL_TDecChanParam* pChParam, AL_CB_EndFrameDecoding callback, AL_TThreadAttr const* pThreadAttr);
   void (* SearchSC)(AL_TIDecChannel* pDecChannel, AL_TScParam* pScParam, AL_TScBufferAddrs* pBufferAddrs, AL_CB_EndStartCode callback);
   void (* DecodeOneFrame)(AL_TIDecChannel* pDecChannel, AL_TDecPicParam* pPictParam, AL_TDecPicBufferAddrs* pPictAddrs, TMemDesc* pSliceParams);
   void (* DecodeOneSlice)(AL_TIDecChannel* pDecChannel, AL_TDecPicParam* pPictParam, AL_TDecPicBufferAddrs* pPictAddrs, TMemDesc* pSliceParams);
@@ -110,13 +110,15 @@ void AL_IDecChannel_Destroy(AL_TIDecChannel* pThis)
    \param[in] pThis Decoder channel
    \param[in] pChParam Pointer to the channel parameter
    \param[in] callback end decoding code callback structure
+   \param[in] pThreadAttr attributes of the thread calling the callback, if
+   the channel creates one. Can be NULL
    \return return the channel ID if the creation is successfull
               255 otherwise(invalide channel ID)
 *****************************************************************************/
 static inline
-AL_ERR AL_IDecChannel_Configure(AL_TIDecChannel* pThis, AL_TDecChanParam* pChParam, AL_CB_EndFrameDecoding callback)
+AL_ERR AL_IDecChannel_Configure(AL_TIDecChannel* pThis, AL_TDecChanParam* pChParam, AL_CB_EndFrameDecoding callback, AL_TThreadAttr const* pThreadAttr)
 {
-  return pThis->vtable->Configure(pThis, pChParam, callback);
+  return pThis->vtable->Configure(pThis, pChParam, callback, pThreadAttr);
 }
 
 /*************************************************************************//*!
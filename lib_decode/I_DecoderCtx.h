@@ -76,6 +76,7 @@ typedef struct t_Dec_Ctx
   // decoder IP handle
   AL_TIDecChannel* pDecChannel;
   AL_TAllocator* pAllocator;
+  AL_TAllocator* pArena; // Control structures of the channel, released all at once on destroy
 
   AL_EChanState eChanState;
 
@@ -166,6 +167,7 @@ typedef struct t_Dec_Ctx
   bool bIsFirstSPSChecked;
   bool bIsBuffersAllocated;
   bool bUseIFramesAsSyncPoint;
+  AL_TThreadAttr tCallbackThread;
   AL_TStreamSettings tStreamSettings;
   AL_TBuffer* eosBuffer;
 
@@ -154,9 +154,11 @@ static void InitNonVclBuf(AL_TDecCtx* pCtx, TCircBuffer* pBufStream)
 
   if(uLengthNAL > pCtx->BufNoAE.tMD.uSize) /* should occurs only on long SEI message */
   {
-    Rtos_Free(pCtx->BufNoAE.tMD.pVirtualAddr);
-    pCtx->BufNoAE.tMD.pVirtualAddr = (uint8_t*)Rtos_Malloc(uLengthNAL);
-    pCtx->BufNoAE.tMD.uSize = uLengthNAL;
+    /* the previous buffer stays in the arena until the decoder is destroyed:
+     * grow geometrically to bound the waste */
+    uint32_t uSize = Max(uLengthNAL, 2 * pCtx->BufNoAE.tMD.uSize);
+    pCtx->BufNoAE.tMD.pVirtualAddr = AL_Allocator_GetVirtualAddr(pCtx->pArena, AL_Allocator_Alloc(pCtx->pArena, uSize));
+    pCtx->BufNoAE.tMD.uSize = uSize;
   }
 
   Rtos_Memset(pCtx->BufNoAE.tMD.pVirtualAddr, 0, pCtx->BufNoAE.tMD.uSize);
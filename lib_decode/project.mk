@@ -18,6 +18,7 @@ LIB_DECODE_SRC+=\
 		lib_decode/Patchworker.c\
 		lib_decode/DecoderFeeder.c\
 		lib_decode/DecChannelMcu.c\
+		lib_decode/EventQueue.c\
 
 LIB_DECODER_SRC:=\
   $(LIB_RTOS_SRC)\
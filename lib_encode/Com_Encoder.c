@@ -189,23 +189,62 @@ void AL_Common_Encoder_NotifyUseLongTerm(AL_TEncoder* pEnc)
 
 
 
+/***************************************************************************/
+static AL_64U RecordStreamSent(AL_TEncCtx* pCtx, AL_TBuffer* pStream, int iLayerID)
+{
+  pCtx->tLayerCtx[iLayerID].StreamSent[pCtx->tLayerCtx[iLayerID].iCurStreamSent] = pStream;
+  int curStreamSent = pCtx->tLayerCtx[iLayerID].iCurStreamSent;
+  pCtx->tLayerCtx[iLayerID].iCurStreamSent = (pCtx->tLayerCtx[iLayerID].iCurStreamSent + 1) % AL_MAX_STREAM_BUFFER;
+  AL_Buffer_Ref(pStream);
+
+  return curStreamSent;
+}
+
 /***************************************************************************/
 bool AL_Common_Encoder_PutStreamBuffer(AL_TEncoder* pEnc, AL_TBuffer* pStream, int iLayerID)
+{
+  return AL_Common_Encoder_PutStreamBuffers(pEnc, &pStream, 1, iLayerID);
+}
+
+/***************************************************************************/
+bool AL_Common_Encoder_PutStreamBuffers(AL_TEncoder* pEnc, AL_TBuffer* ppStreams[], int iNumStreams, int iLayerID)
 {
   AL_TEncCtx* pCtx = pEnc->pCtx;
-  AL_TStreamMetaData* pMetaData = (AL_TStreamMetaData*)AL_Buffer_GetMetaData(pStream, AL_META_TYPE_STREAM);
-  assert(pMetaData);
   assert(pCtx);
 
-  AL_StreamMetaData_ClearAllSections(pMetaData);
+  for(int i = 0; i < iNumStreams; ++i)
+  {
+    AL_TStreamMetaData* pMetaData = (AL_TStreamMetaData*)AL_Buffer_GetMetaData(ppStreams[i], AL_META_TYPE_STREAM);
+    assert(pMetaData);
+    AL_StreamMetaData_ClearAllSections(pMetaData);
+  }
+
   Rtos_GetMutex(pCtx->Mutex);
-  pCtx->tLayerCtx[iLayerID].StreamSent[pCtx->tLayerCtx[iLayerID].iCurStreamSent] = pStream;
-  int curStreamSent = pCtx->tLayerCtx[iLayerID].iCurStreamSent;
-  pCtx->tLayerCtx[iLayerID].iCurStreamSent = (pCtx->tLayerCtx[iLayerID].iCurStreamSent + 1) % AL_MAX_STREAM_BUFFER;
-  AL_Buffer_Ref(pStream);
+
+  AL_HANDLE hChannel = pCtx->tLayerCtx[iLayerID].hChannel;
 
   /* Can call AL_Common_Encoder_PutStreamBuffer again */
-  AL_ISchedulerEnc_PutStreamBuffer(pCtx->pScheduler, pCtx->tLayerCtx[iLayerID].hChannel, pStream, curStreamSent, ENC_MAX_HEADER_SIZE);
+  if(iNumStreams == 1)
+  {
+    AL_64U streamSent = RecordStreamSent(pCtx, ppStreams[0], iLayerID);
+    AL_ISchedulerEnc_PutStreamBuffer(pCtx->pScheduler, hChannel, ppStreams[0], streamSent, ENC_MAX_HEADER_SIZE);
+  }
+  else
+  {
+    /* hand the buffers to the scheduler by chunks, so that it can give them to the driver in one go */
+    AL_64U streamsSent[AL_MAX_STREAM_BUFFER];
+
+    for(int iFirst = 0; iFirst < iNumStreams; iFirst += AL_MAX_STREAM_BUFFER)
+    {
+      int iNumChunk = Min(iNumStreams - iFirst, AL_MAX_STREAM_BUFFER);
+
+      for(int i = 0; i < iNumChunk; ++i)
+        streamsSent[i] = RecordStreamSent(pCtx, ppStreams[iFirst + i], iLayerID);
+
+      AL_ISchedulerEnc_PutStreamBuffers(pCtx->pScheduler, hChannel, &ppStreams[iFirst], streamsSent, iNumChunk, ENC_MAX_HEADER_SIZE);
+    }
+  }
+
   Rtos_ReleaseMutex(pCtx->Mutex);
 
   return true;
@@ -925,6 +964,7 @@ AL_ERR AL_Common_Encoder_CreateChannel(AL_TEncCtx* pCtx, TScheduler* pScheduler,
   AL_TISchedulerCallBacks CBs = { 0 };
   CBs.pfnEndEncodingCallBack = EndEncoding;
   CBs.pEndEncodingCBParam = &pCtx->tLayerCtx[0].callback_user_param;
+  CBs.pThreadAttr = &pSettings->tCallbackThread;
 
   // HACK: needed to preprocess scaling list, but doesn't generate the good nals
   // because we are missing some value populated by AL_ISchedulerEnc_CreateChannel
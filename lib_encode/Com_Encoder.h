@@ -96,6 +96,12 @@ void AL_Common_Encoder_NotifyUseLongTerm(AL_TEncoder* pEnc);
 *****************************************************************************/
 bool AL_Common_Encoder_PutStreamBuffer(AL_TEncoder* pEnc, AL_TBuffer* pStream, int iLayerID);
 
+/*************************************************************************//*!
+   \brief Pushes several stream buffers at once, the context is locked once
+   \see AL_Common_Encoder_PutStreamBuffer
+*****************************************************************************/
+bool AL_Common_Encoder_PutStreamBuffers(AL_TEncoder* pEnc, AL_TBuffer* ppStreams[], int iNumStreams, int iLayerID);
+
 /***************************************************************************/
 bool AL_Common_Encoder_GetRecPicture(AL_TEncoder* pEnc, TRecPic* pRecPic, int iLayerID);
 
@@ -162,9 +162,6 @@ void WriteFillerData(AL_TBitStreamLite* pStream, uint8_t uNUT, NalHeader header,
 void AddFlagsToAllSections(AL_TStreamMetaData* pStreamMeta, uint32_t flags)
 {
   for(int i = 0; i < pStreamMeta->uNumSection; i++)
-  {
-    AL_TStreamSection section = pStreamMeta->pSections[i];
-    AL_StreamMetaData_SetSectionFlags(pStreamMeta, i, flags | section.uFlags);
-  }
+    pStreamMeta->pSections[i].uFlags |= flags;
 }
 
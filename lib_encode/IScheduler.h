@@ -46,6 +46,7 @@
 #pragma once
 
 #include "lib_rtos/types.h"
+#include "lib_rtos/lib_rtos.h"
 #include "lib_common_enc/EncPicInfo.h"
 #include "lib_common_enc/EncChanParam.h"
 #include "lib_common_enc/EncRecBuffer.h"
@@ -64,6 +65,7 @@ typedef struct AL_t_ISchedulerCallBacks
 {
   AL_PFN_iChannel_CB pfnEndEncodingCallBack;
   void* pEndEncodingCBParam;
+  AL_TThreadAttr const* pThreadAttr; /* attributes of the thread calling the callbacks, if the scheduler creates one. Can be NULL */
 }AL_TISchedulerCallBacks;
 
 /****************************************************************************/
@@ -81,6 +83,7 @@ typedef struct t_SchedulerVtable
   bool (* destroyChannel)(TScheduler* pScheduler, AL_HANDLE hChannel);
   bool (* encodeOneFrame)(TScheduler* pScheduler, AL_HANDLE hChannel, AL_TEncInfo* pEncInfo, AL_TEncRequestInfo* pReqInfo, AL_TEncPicBufAddrs* pBufferAddrs);
   void (* putStreamBuffer)(TScheduler* pScheduler, AL_HANDLE hChannel, AL_TBuffer* pStream, AL_64U streamUserPtr, uint32_t uOffset);
+  void (* putStreamBuffers)(TScheduler* pScheduler, AL_HANDLE hChannel, AL_TBuffer* pStreams[], AL_64U streamUserPtrs[], int iNumStreams, uint32_t uOffset);
   bool (* getRecPicture)(TScheduler* pScheduler, AL_HANDLE hChannel, TRecPic* pRecPic);
   bool (* releaseRecPicture)(TScheduler* pScheduler, AL_HANDLE hChannel, TRecPic* pRecPic);
 
@@ -141,6 +144,21 @@ void AL_ISchedulerEnc_PutStreamBuffer(TScheduler* pScheduler, AL_HANDLE hChannel
   pScheduler->vtable->putStreamBuffer(pScheduler, hChannel, pStream, streamUserPtr, uOffset);
 }
 
+/*************************************************************************//*!
+   \brief Give several stream buffers at once
+   \param[in] hChannel Channel identifier
+   \param[in] pStreams stream buffers given for the scheduler to fill
+   \param[in] streamUserPtrs user pointer of each stream buffer
+   \param[in] iNumStreams number of stream buffers
+   \param[in] uOffset offset in the stream buffers data
+   \see AL_ISchedulerEnc_PutStreamBuffer
+*****************************************************************************/
+static inline
+void AL_ISchedulerEnc_PutStreamBuffers(TScheduler* pScheduler, AL_HANDLE hChannel, AL_TBuffer* pStreams[], AL_64U streamUserPtrs[], int iNumStreams, uint32_t uOffset)
+{
+  pScheduler->vtable->putStreamBuffers(pScheduler, hChannel, pStreams, streamUserPtrs, iNumStreams, uOffset);
+}
+
 /*************************************************************************//*!
    \brief Asks for a reconstructed picture
    \param[in] hChannel Channel identifier
@@ -39,16 +39,19 @@
 #include "lib_encode/SchedulerMcu.h"
 #include "lib_encode/ISchedulerCommon.h"
 #include "lib_common/IDriver.h"
+#include "lib_common/EventReactor.h"
 
 #include "lib_rtos/lib_rtos.h"
 #include "lib_fpga/DmaAlloc.h"
 #include "lib_common/Error.h"
+#include "lib_common/Utils.h"
 
 typedef struct al_t_SchedulerMcu
 {
   const TSchedulerVtable* vtable;
   AL_TAllocator* allocator;
   AL_TDriver* driver;
+  AL_TEventReactor* reactor;
 }AL_TSchedulerMcu;
 
 typedef struct
@@ -58,8 +61,12 @@ typedef struct
   AL_TDriver* driver;
   int fd;
   AL_THREAD thread;
+  AL_TEventReactor* reactor;
+  AL_TEventSource* statusSource;
   int32_t shouldContinue;
   bool outputRec;
+  /* cleared when the driver doesn't support AL_MCU_PUT_STREAM_BUFFERS */
+  bool hasVectoredPut;
 }Channel;
 
 #if __linux__
@@ -76,6 +83,7 @@ typedef struct
 
 static const char* deviceFile = "/dev/allegroIP";
 static void* WaitForStatus(void* p);
+static bool OnStatusReady(void* p);
 
 static void setChannelFeedback(AL_TEncChanParam* pChParam, struct al5_channel_status* msg)
 {
@@ -138,10 +146,33 @@ static AL_ERR createChannel(AL_HANDLE* hChannel, TScheduler* pScheduler, AL_TEnc
   setChannelFeedback(pChParam, &msg.status);
   setCallbacks(chan, pCBs);
   chan->shouldContinue = 1;
-  chan->thread = Rtos_CreateThread(&WaitForStatus, chan);
+  chan->hasVectoredPut = true;
+  chan->reactor = schedulerMcu->reactor;
 
-  if(!chan->thread)
-    goto fail;
+  if(chan->reactor)
+  {
+    chan->statusSource = AL_EventReactor_Add(chan->reactor, chan->fd, &OnStatusReady, chan);
+
+    /* the driver can't be polled, wait for the statuses in a thread instead */
+    if(!chan->statusSource)
+      chan->reactor = NULL;
+  }
+
+  if(!chan->reactor)
+  {
+    AL_TThreadAttr threadAttr = { 0 };
+
+    if(pCBs->pThreadAttr)
+      threadAttr = *pCBs->pThreadAttr;
+
+    if(!threadAttr.pName)
+      threadAttr.pName = "al_enc_status";
+
+    chan->thread = Rtos_CreateThreadWithAttr(&WaitForStatus, chan, &threadAttr);
+
+    if(!chan->thread)
+      goto fail;
+  }
 
   SetChannelInfo(&chan->info, pChParam);
   *hChannel = (AL_HANDLE)chan;
@@ -194,9 +225,14 @@ static bool destroyChannel(TScheduler* pScheduler, AL_HANDLE hChannel)
 
   AL_Driver_PostMessage(schedulerMcu->driver, chan->fd, AL_MCU_DESTROY_CHANNEL, NULL);
 
-  if(!Rtos_JoinThread(chan->thread))
-    return false;
-  Rtos_DeleteThread(chan->thread);
+  if(chan->reactor)
+    AL_EventReactor_Remove(chan->reactor, chan->statusSource);
+  else
+  {
+    if(!Rtos_JoinThread(chan->thread))
+      return false;
+    Rtos_DeleteThread(chan->thread);
+  }
 
   AL_Driver_Close(schedulerMcu->driver, chan->fd);
 
@@ -295,6 +331,21 @@ static void* WaitForStatus(void* p)
   return 0;
 }
 
+static bool OnStatusReady(void* p)
+{
+  Channel* chan = p;
+  struct al5_params msg = { 0 };
+
+  if(Rtos_AtomicDecrement(&chan->shouldContinue) < 0)
+    return false;
+  Rtos_AtomicIncrement(&chan->shouldContinue);
+
+  if(getStatusMsg(chan, &msg))
+    processStatusMsg(chan, &msg);
+
+  return true;
+}
+
 static void destroy(TScheduler* pScheduler)
 {
   Rtos_Free((AL_TSchedulerMcu*)pScheduler);
@@ -324,6 +375,60 @@ static void putStreamBuffer(TScheduler* pScheduler, AL_HANDLE hChannel, AL_TBuff
   AL_Driver_PostMessage(schedulerMcu->driver, chan->fd, AL_MCU_PUT_STREAM_BUFFER, &driverBuffer);
 }
 
+#define MAX_VECTORED_PUT 16
+
+static AL_EDriverError putStreamBuffersVectored(AL_TSchedulerMcu* schedulerMcu, Channel* chan, AL_TBuffer* streamBuffers[], AL_64U streamUserPtrs[], int iNumStreams, uint32_t uOffset)
+{
+  struct al5_buffer driverBuffers[MAX_VECTORED_PUT];
+  assert(iNumStreams <= MAX_VECTORED_PUT);
+
+  for(int i = 0; i < iNumStreams; ++i)
+    createPutStreamMsg(&driverBuffers[i], streamBuffers[i], streamUserPtrs[i], uOffset);
+
+  struct al5_buffers msg = { 0 };
+  msg.buffers = (__u64)(uintptr_t)driverBuffers;
+  msg.num_buffers = iNumStreams;
+
+  return AL_Driver_PostMessage(schedulerMcu->driver, chan->fd, AL_MCU_PUT_STREAM_BUFFERS, &msg);
+}
+
+static void putStreamBuffers(TScheduler* pScheduler, AL_HANDLE hChannel, AL_TBuffer* streamBuffers[], AL_64U streamUserPtrs[], int iNumStreams, uint32_t uOffset)
+{
+  AL_TSchedulerMcu* schedulerMcu = (AL_TSchedulerMcu*)pScheduler;
+  Channel* chan = (Channel*)hChannel;
+  int iFirst = 0;
+
+  while(iFirst < iNumStreams && chan->hasVectoredPut)
+  {
+    int iNumChunk = Min(iNumStreams - iFirst, MAX_VECTORED_PUT);
+
+    if(iNumChunk == 1)
+      break;
+
+    AL_EDriverError eErr = putStreamBuffersVectored(schedulerMcu, chan, &streamBuffers[iFirst], &streamUserPtrs[iFirst], iNumChunk, uOffset);
+
+    if(eErr == DRIVER_ERROR_CHANNEL || eErr == DRIVER_ERROR_UNKNOWN)
+    {
+      /* the driver doesn't know the ioctl (EINVAL, ENOTTY): nothing was
+       * queued, fall back to one message per buffer from now on */
+      chan->hasVectoredPut = false;
+      break;
+    }
+
+    if(eErr != DRIVER_SUCCESS)
+    {
+      /* other errors may be transient: only this chunk goes one by one */
+      for(int i = 0; i < iNumChunk; ++i)
+        putStreamBuffer(pScheduler, hChannel, streamBuffers[iFirst + i], streamUserPtrs[iFirst + i], uOffset);
+    }
+
+    iFirst += iNumChunk;
+  }
+
+  for(; iFirst < iNumStreams; ++iFirst)
+    putStreamBuffer(pScheduler, hChannel, streamBuffers[iFirst], streamUserPtrs[iFirst], uOffset);
+}
+
 
 
 static const TSchedulerVtable McuSchedulerVtable =
@@ -333,11 +438,12 @@ static const TSchedulerVtable McuSchedulerVtable =
   &destroyChannel,
   &encodeOneFrame,
   &putStreamBuffer,
+  &putStreamBuffers,
   &getRecPicture,
   &releaseRecPicture,
 };
 
-TScheduler* AL_SchedulerMcu_Create(AL_TDriver* driver, AL_TAllocator* pDmaAllocator)
+TScheduler* AL_SchedulerMcu_CreateWithReactor(AL_TDriver* driver, AL_TAllocator* pDmaAllocator, AL_TEventReactor* pReactor)
 {
   AL_TSchedulerMcu* scheduler = Rtos_Malloc(sizeof(*scheduler));
 
@@ -346,11 +452,23 @@ TScheduler* AL_SchedulerMcu_Create(AL_TDriver* driver, AL_TAllocator* pDmaAlloca
   scheduler->vtable = &McuSchedulerVtable;
   scheduler->driver = driver;
   scheduler->allocator = pDmaAllocator;
+  scheduler->reactor = pReactor;
   return (TScheduler*)scheduler;
 }
 
+TScheduler* AL_SchedulerMcu_Create(AL_TDriver* driver, AL_TAllocator* pDmaAllocator)
+{
+  return AL_SchedulerMcu_CreateWithReactor(driver, pDmaAllocator, NULL);
+}
+
 #else
 
+TScheduler* AL_SchedulerMcu_CreateWithReactor(AL_TDriver* driver, AL_TAllocator* pDmaAllocator, AL_TEventReactor* pReactor)
+{
+  (void)driver, (void)pDmaAllocator, (void)pReactor;
+  return NULL;
+}
+
 TScheduler* AL_SchedulerMcu_Create(AL_TDriver* driver, AL_TAllocator* pDmaAllocator)
 {
   (void)driver, (void)pDmaAllocator;
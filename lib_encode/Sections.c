@@ -208,8 +208,23 @@ void GenerateSections(IRbspWriter* writer, Nuts nuts, const NalsData* nalsData,
 
   AL_TStreamPart* pStreamParts = (AL_TStreamPart*)(AL_Buffer_GetData(pStream) + pPicStatus->uStreamPartOffset);
 
-  for(int iPart = 0; iPart < pPicStatus->iNumParts; ++iPart)
-    AddSection(pMetaData, pStreamParts[iPart].uOffset, pStreamParts[iPart].uSize, 0);
+  AL_TStreamSection* pPartSections = AL_StreamMetaData_AppendSections(pMetaData, pPicStatus->iNumParts);
+
+  if(pPartSections)
+  {
+    for(int iPart = 0; iPart < pPicStatus->iNumParts; ++iPart)
+    {
+      pPartSections[iPart].uOffset = pStreamParts[iPart].uOffset;
+      pPartSections[iPart].uLength = pStreamParts[iPart].uSize;
+      pPartSections[iPart].uFlags = 0;
+    }
+  }
+  else
+  {
+    /* the parts don't all fit: add the ones that do, one by one */
+    for(int iPart = 0; iPart < pPicStatus->iNumParts; ++iPart)
+      AddSection(pMetaData, pStreamParts[iPart].uOffset, pStreamParts[iPart].uSize, 0);
+  }
 
   int offset = getOffsetAfterLastSection(pMetaData);
   AL_TBitStreamLite bs;
@@ -155,6 +155,13 @@ bool AL_Encoder_PutStreamBuffer(AL_HEncoder hEnc, AL_TBuffer* pStream)
   return AL_Common_Encoder_PutStreamBuffer(pEnc, pStream, 0);
 }
 
+/****************************************************************************/
+bool AL_Encoder_PutStreamBuffers(AL_HEncoder hEnc, AL_TBuffer* ppStreams[], int iNumStreams)
+{
+  AL_TEncoder* pEnc = (AL_TEncoder*)hEnc;
+  return AL_Common_Encoder_PutStreamBuffers(pEnc, ppStreams, iNumStreams, 0);
+}
+
 /****************************************************************************/
 bool AL_Encoder_Process(AL_HEncoder hEnc, AL_TBuffer* pFrame, AL_TBuffer* pQpTable)
 {
@@ -46,33 +46,98 @@
 
 #include "DevicePool.h"
 
+/*
+ * Devices are shared: opening the same file twice gives back the same fd.
+ *
+ * Entries are never freed before the pool is: once a filename has been
+ * opened, its entry stays in its hash chain and is reused if the file is
+ * opened again. This lets Open and Close walk the chains and the fd index
+ * without lock. The mutex is only taken to open the file the first time or
+ * to close it when the last reference goes away.
+ */
 struct FileDesc
 {
+  struct FileDesc* pNext; /* hash chain, only grows */
   char* filename;
   int iRefCount;
   int fd;
 };
 
-#define POOL_SIZE 32
+#define NUM_BUCKETS 64
+#define INITIAL_FD_TABLE_SIZE 64
+
+/* fds are small integers: the fd index is a plain array. A bigger one replaces
+ * it when a fd doesn't fit. Replaced tables are kept until the pool goes away
+ * as lock-free readers may still be looking at them */
+struct FdTable
+{
+  struct FdTable* pRetired;
+  int iSize;
+  struct FileDesc* pEntries[];
+};
 
 struct DevicePool
 {
-  struct FileDesc pPool[POOL_SIZE];
+  struct FileDesc* pBuckets[NUM_BUCKETS];
+  struct FdTable* pFdTable;
   AL_MUTEX pLock;
 };
 
+static uint32_t HashFilename(const char* filename)
+{
+  /* FNV-1a */
+  uint32_t uHash = 2166136261u;
+
+  for(; *filename; ++filename)
+    uHash = (uHash ^ (uint8_t)*filename) * 16777619u;
+
+  return uHash;
+}
+
 static bool DevicePool_Init(struct DevicePool* pDP)
 {
-  pDP->pLock = Rtos_CreateMutex();
+  AL_MUTEX pLock = Rtos_CreateMutex();
 
-  if(!pDP->pLock)
+  if(!pLock)
     return false;
 
+  AL_MUTEX pExpected = NULL;
+
+  /* several threads can race on the first open */
+  if(!__atomic_compare_exchange_n(&pDP->pLock, &pExpected, pLock, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    Rtos_DeleteMutex(pLock);
+
   return true;
 }
 
 static void DevicePool_Deinit(struct DevicePool* pDP)
 {
+  for(int i = 0; i < NUM_BUCKETS; ++i)
+  {
+    struct FileDesc* pCur = pDP->pBuckets[i];
+
+    while(pCur)
+    {
+      struct FileDesc* pNext = pCur->pNext;
+      free(pCur->filename);
+      free(pCur);
+      pCur = pNext;
+    }
+
+    pDP->pBuckets[i] = NULL;
+  }
+
+  struct FdTable* pTable = pDP->pFdTable;
+
+  while(pTable)
+  {
+    struct FdTable* pRetired = pTable->pRetired;
+    free(pTable);
+    pTable = pRetired;
+  }
+
+  pDP->pFdTable = NULL;
+
   if(pDP->pLock)
     Rtos_DeleteMutex(pDP->pLock);
   pDP->pLock = NULL;
@@ -80,84 +145,152 @@ static void DevicePool_Deinit(struct DevicePool* pDP)
 
 static struct FileDesc* DevicePool_FindEntryByFd(struct DevicePool* pDP, int fd)
 {
-  size_t i;
-  struct FileDesc* pCur;
+  struct FdTable* pTable = __atomic_load_n(&pDP->pFdTable, __ATOMIC_ACQUIRE);
 
-  for(i = 0; i < POOL_SIZE; ++i)
-  {
-    pCur = &pDP->pPool[i];
+  if(!pTable || fd < 0 || fd >= pTable->iSize)
+    return NULL;
+
+  return __atomic_load_n(&pTable->pEntries[fd], __ATOMIC_ACQUIRE);
+}
+
+static struct FileDesc* DevicePool_FindEntryByName(struct DevicePool* pDP, const char* filename)
+{
+  struct FileDesc* pCur = __atomic_load_n(&pDP->pBuckets[HashFilename(filename) % NUM_BUCKETS], __ATOMIC_ACQUIRE);
 
-    if(pCur->iRefCount && fd == pCur->fd)
+  for(; pCur; pCur = __atomic_load_n(&pCur->pNext, __ATOMIC_ACQUIRE))
+  {
+    if(strcmp(filename, pCur->filename) == 0)
       return pCur;
   }
 
   return NULL;
 }
 
-static struct FileDesc* DevicePool_FindEntryByName(struct DevicePool* pDP, const char* filename)
+/* Should be called with the lock held */
+static struct FileDesc* DevicePool_AddEntry(struct DevicePool* pDP, const char* filename)
 {
-  size_t i;
-  struct FileDesc* pCur;
+  struct FileDesc* pEntry = (struct FileDesc*)calloc(1, sizeof(*pEntry));
+
+  if(!pEntry)
+    return NULL;
+
+  pEntry->filename = strdup(filename);
 
-  for(i = 0; i < POOL_SIZE; ++i)
+  if(!pEntry->filename)
   {
-    pCur = &pDP->pPool[i];
+    free(pEntry);
+    return NULL;
+  }
 
-    if(pCur->iRefCount > 0 && strcmp(filename, pCur->filename) == 0)
-      return pCur;
+  pEntry->fd = -1;
+
+  struct FileDesc** ppBucket = &pDP->pBuckets[HashFilename(filename) % NUM_BUCKETS];
+  pEntry->pNext = *ppBucket;
+  __atomic_store_n(ppBucket, pEntry, __ATOMIC_RELEASE);
+
+  return pEntry;
+}
+
+/* Should be called with the lock held */
+static bool DevicePool_IndexFd(struct DevicePool* pDP, int fd, struct FileDesc* pEntry)
+{
+  struct FdTable* pTable = pDP->pFdTable;
+
+  if(!pTable || fd >= pTable->iSize)
+  {
+    int iSize = pTable ? pTable->iSize : INITIAL_FD_TABLE_SIZE;
+
+    while(fd >= iSize)
+      iSize *= 2;
+
+    struct FdTable* pNew = (struct FdTable*)calloc(1, sizeof(*pNew) + iSize * sizeof(pNew->pEntries[0]));
+
+    if(!pNew)
+      return false;
+
+    pNew->iSize = iSize;
+    pNew->pRetired = pTable;
+
+    if(pTable)
+      memcpy(pNew->pEntries, pTable->pEntries, pTable->iSize * sizeof(pTable->pEntries[0]));
+
+    __atomic_store_n(&pDP->pFdTable, pNew, __ATOMIC_RELEASE);
+    pTable = pNew;
   }
 
-  return NULL;
+  __atomic_store_n(&pTable->pEntries[fd], pEntry, __ATOMIC_RELEASE);
+  return true;
 }
 
-static struct FileDesc* DevicePool_FindFreeEntry(struct DevicePool* pDP)
+/* Takes a reference if the entry is still open. The fd is published before
+ * the reference count leaves 0, so it is valid once the reference is taken */
+static bool DevicePool_TryRef(struct FileDesc* pEntry)
 {
-  size_t i;
-  struct FileDesc* pCur;
+  int iRefCount = __atomic_load_n(&pEntry->iRefCount, __ATOMIC_RELAXED);
 
-  for(i = 0; i < POOL_SIZE; ++i)
+  while(iRefCount > 0)
   {
-    pCur = &pDP->pPool[i];
+    if(__atomic_compare_exchange_n(&pEntry->iRefCount, &iRefCount, iRefCount + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      return true;
+  }
 
-    if(pCur->iRefCount == 0)
-      return pCur;
+  return false;
+}
+
+/* Drops a reference unless it is the last one */
+static bool DevicePool_TryUnref(struct FileDesc* pEntry)
+{
+  int iRefCount = __atomic_load_n(&pEntry->iRefCount, __ATOMIC_RELAXED);
+
+  while(iRefCount > 1)
+  {
+    if(__atomic_compare_exchange_n(&pEntry->iRefCount, &iRefCount, iRefCount - 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+      return true;
   }
 
-  return NULL;
+  return false;
 }
 
 static int DevicePool_Open(struct DevicePool* pDP, const char* filename)
 {
-  int iRet = 0;
-  struct FileDesc* pCur;
+  int iRet = -1;
+  struct FileDesc* pCur = DevicePool_FindEntryByName(pDP, filename);
+
+  if(pCur && DevicePool_TryRef(pCur))
+    return pCur->fd;
 
   Rtos_GetMutex(pDP->pLock);
 
-  pCur = DevicePool_FindEntryByName(pDP, filename);
+  if(!pCur)
+    pCur = DevicePool_FindEntryByName(pDP, filename);
+
+  if(!pCur)
+    pCur = DevicePool_AddEntry(pDP, filename);
 
   if(!pCur)
+    goto exit;
+
+  /* reopened by another thread while we were waiting for the lock */
+  if(DevicePool_TryRef(pCur))
   {
-    pCur = DevicePool_FindFreeEntry(pDP);
+    iRet = pCur->fd;
+    goto exit;
+  }
 
-    if(!pCur)
-    {
-      iRet = -1;
-      goto exit;
-    }
+  int fd = open(filename, O_RDWR);
 
-    pCur->filename = strdup(filename);
-    pCur->fd = open(filename, O_RDWR);
+  if(fd < 0)
+    goto exit;
 
-    if(pCur->fd < 0)
-    {
-      iRet = -1;
-      free(pCur->filename);
-      goto exit;
-    }
+  if(!DevicePool_IndexFd(pDP, fd, pCur))
+  {
+    close(fd);
+    goto exit;
   }
 
-  pCur->iRefCount++;
-  iRet = pCur->fd;
+  pCur->fd = fd;
+  __atomic_store_n(&pCur->iRefCount, 1, __ATOMIC_RELEASE);
+  iRet = fd;
 
   exit:
   Rtos_ReleaseMutex(pDP->pLock);
@@ -166,28 +299,30 @@ static int DevicePool_Open(struct DevicePool* pDP, const char* filename)
 
 static int DevicePool_Close(struct DevicePool* pDP, int fd)
 {
-  struct FileDesc* pEntry;
   int iRet = 0;
-  Rtos_GetMutex(pDP->pLock);
-
-  pEntry = DevicePool_FindEntryByFd(pDP, fd);
+  struct FileDesc* pEntry = DevicePool_FindEntryByFd(pDP, fd);
 
   if(!pEntry)
   {
     /* We don't have this file descriptor */
-    iRet = -1;
-    goto exit;
+    return -1;
   }
 
-  assert(pEntry->iRefCount > 0);
+  if(DevicePool_TryUnref(pEntry))
+    return 0;
 
-  pEntry->iRefCount -= 1;
+  Rtos_GetMutex(pDP->pLock);
 
-  if(pEntry->iRefCount == 0)
-  {
-    free(pEntry->filename);
-    iRet = close(pEntry->fd);
-  }
+  assert(pEntry->fd == fd);
+
+  /* lock-free opens may still take references until the count drops to 0.
+   * From then on, no TryRef can succeed and only the lock holder can reopen */
+  if(__atomic_sub_fetch(&pEntry->iRefCount, 1, __ATOMIC_ACQ_REL) > 0)
+    goto exit;
+
+  __atomic_store_n(&pDP->pFdTable->pEntries[fd], NULL, __ATOMIC_RELAXED);
+  pEntry->fd = -1;
+  iRet = close(fd);
 
   exit:
   Rtos_ReleaseMutex(pDP->pLock);
@@ -199,7 +334,7 @@ static int DevicePool_Close(struct DevicePool* pDP, int fd)
 
 #include <stdlib.h>
 
-static bool g_DevicePoolInit;
+static int g_DevicePoolInit;
 static struct DevicePool g_DevicePool;
 
 static
@@ -211,17 +346,21 @@ void AL_DevicePool_Deinit()
 static
 bool AL_DevicePool_Init()
 {
-  atexit(&AL_DevicePool_Deinit);
-  return DevicePool_Init(&g_DevicePool);
+  if(!DevicePool_Init(&g_DevicePool))
+    return false;
+
+  int iExpected = 0;
+
+  if(__atomic_compare_exchange_n(&g_DevicePoolInit, &iExpected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    atexit(&AL_DevicePool_Deinit);
+
+  return true;
 }
 
 int AL_DevicePool_Open(const char* filename)
 {
-  if(!g_DevicePoolInit)
-  {
-    AL_DevicePool_Init();
-    g_DevicePoolInit = true;
-  }
+  if(!__atomic_load_n(&g_DevicePoolInit, __ATOMIC_ACQUIRE) && !AL_DevicePool_Init())
+    return -1;
 
   return DevicePool_Open(&g_DevicePool, filename);
 }
@@ -38,6 +38,9 @@
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <fcntl.h>
 
 #include <stdio.h>
 #include <errno.h>
@@ -47,6 +50,7 @@
 
 #include "lib_fpga/DmaAllocLinux.h"
 #include "lib_rtos/types.h"
+#include "lib_rtos/lib_rtos.h"
 #include "allegro_ioctl_reg.h"
 #include "DevicePool.h"
 
@@ -61,6 +65,24 @@ static void LogAllocation(struct DmaBuffer* p)
 #define LOG_ALLOCATION(p)
 #endif
 
+/* An imported dmabuf, kept after its last handle is freed so that importing
+ * it again reuses its bus address and its mapping. It holds its own fd on
+ * the dmabuf, which keeps the buffer (and its inode number) alive: idle
+ * imports are bounded in size and in time so that they don't pin memory
+ * their exporter has released. */
+struct DmaImport
+{
+  dev_t dev;
+  ino_t ino;
+  int fd; /* -1 if the slot is free */
+  uint32_t phy_addr;
+  size_t size;
+  AL_VADDR vaddr; /* mapped on first CPU access, unmapped on eviction */
+  int refCount; /* number of live handles */
+  AL_64U lastUse;
+  AL_64U idleSince; /* Rtos_GetTime when refCount dropped to 0 */
+};
+
 struct DmaBuffer
 {
   /* ioctl structure */
@@ -70,6 +92,20 @@ struct DmaBuffer
   size_t offset;
   size_t mmap_offset; /* used by non-dmabuf */
   bool shouldCloseFd;
+  struct DmaImport* pImport; /* set if the handle comes from the import cache */
+};
+
+#define MAX_IMPORT_CACHE 32
+/* the idle imports are dropped beyond this size or after this time, checked
+ * each time the cache is used */
+#define MAX_IMPORT_CACHE_IDLE_SIZE (64 * 1024 * 1024)
+#define IMPORT_CACHE_IDLE_TIMEOUT 1000 /* ms */
+
+enum
+{
+  IMPORT_CACHE_UNKNOWN,
+  IMPORT_CACHE_ENABLED,
+  IMPORT_CACHE_DISABLED,
 };
 
 #define MAX_DEVICE_FILE_NAME 30
@@ -78,18 +114,122 @@ struct LinuxDmaCtx
   AL_TLinuxDmaAllocator base;
   char deviceFile[MAX_DEVICE_FILE_NAME];
   int fd;
+
+  AL_MUTEX importMutex;
+  int importCacheState;
+  AL_64U importClock;
+  struct DmaImport imports[MAX_IMPORT_CACHE];
 };
 
+/******************************************************************************/
+static AL_VADDR LinuxDma_Map(int fd, size_t zSize, size_t offset)
+{
+  AL_VADDR vaddr = (AL_VADDR)mmap(0, zSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+
+  if(vaddr == MAP_FAILED)
+  {
+    perror("MAP_FAILED");
+    return NULL;
+  }
+  return vaddr;
+}
+
+/******************************************************************************/
+static void DropImport(struct DmaImport* pImport)
+{
+  if(pImport->vaddr && munmap(pImport->vaddr, pImport->size) == -1)
+    perror("munmap");
+  close(pImport->fd);
+  pImport->fd = -1;
+}
+
+/******************************************************************************/
+static bool IsIdleImport(struct DmaImport const* pImport)
+{
+  return pImport->fd >= 0 && pImport->refCount == 0;
+}
+
+/******************************************************************************/
+static struct DmaImport* GetOldestIdleImport(struct LinuxDmaCtx* pCtx)
+{
+  struct DmaImport* pOldest = NULL;
+
+  for(int i = 0; i < MAX_IMPORT_CACHE; ++i)
+  {
+    struct DmaImport* pImport = &pCtx->imports[i];
+
+    if(IsIdleImport(pImport) && (!pOldest || pImport->lastUse < pOldest->lastUse))
+      pOldest = pImport;
+  }
+
+  return pOldest;
+}
+
+/* Should be called with the import mutex held. Drops the imports idle for
+ * too long, then the least recently used ones above the idle size limit */
+static void TrimImports(struct LinuxDmaCtx* pCtx, size_t zMaxIdleSize)
+{
+  AL_64U uNow = Rtos_GetTime();
+  size_t zIdleSize = 0;
+
+  for(int i = 0; i < MAX_IMPORT_CACHE; ++i)
+  {
+    struct DmaImport* pImport = &pCtx->imports[i];
+
+    if(!IsIdleImport(pImport))
+      continue;
+
+    if(uNow - pImport->idleSince >= IMPORT_CACHE_IDLE_TIMEOUT)
+      DropImport(pImport);
+    else
+      zIdleSize += pImport->size;
+  }
+
+  while(zIdleSize > zMaxIdleSize)
+  {
+    struct DmaImport* pOldest = GetOldestIdleImport(pCtx);
+    zIdleSize -= pOldest->size;
+    DropImport(pOldest);
+  }
+}
+
+/******************************************************************************/
+static void ReleaseImport(struct LinuxDmaCtx* pCtx, struct DmaImport* pImport)
+{
+  Rtos_GetMutex(pCtx->importMutex);
+
+  if(--pImport->refCount == 0)
+    pImport->idleSince = Rtos_GetTime();
+
+  TrimImports(pCtx, MAX_IMPORT_CACHE_IDLE_SIZE);
+  Rtos_ReleaseMutex(pCtx->importMutex);
+}
+
+/* The idle imports may be the last references on buffers of the same memory pool */
+static void FlushIdleImports(struct LinuxDmaCtx* pCtx)
+{
+  Rtos_GetMutex(pCtx->importMutex);
+  TrimImports(pCtx, 0);
+  Rtos_ReleaseMutex(pCtx->importMutex);
+}
+
 /******************************************************************************/
 static bool LinuxDma_Free(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
 {
-  (void)pAllocator;
   struct DmaBuffer* pDmaBuffer = (struct DmaBuffer*)hBuf;
   bool bRet = true;
 
   if(!pDmaBuffer)
     return true;
 
+  /* the mapping belongs to the cache and stays there for the next import */
+  if(pDmaBuffer->pImport)
+  {
+    ReleaseImport((struct LinuxDmaCtx*)pAllocator, pDmaBuffer->pImport);
+    free(pDmaBuffer);
+    return true;
+  }
+
   if(pDmaBuffer->vaddr && (munmap(pDmaBuffer->vaddr - pDmaBuffer->offset, pDmaBuffer->info.size) == -1))
   {
     bRet = false;
@@ -104,28 +244,35 @@ static bool LinuxDma_Free(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
   return bRet;
 }
 
-static AL_VADDR LinuxDma_Map(int fd, size_t zSize, size_t offset)
+/******************************************************************************/
+static AL_VADDR GetImportVirtualAddr(struct LinuxDmaCtx* pCtx, struct DmaImport* pImport)
 {
-  AL_VADDR vaddr = (AL_VADDR)mmap(0, zSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+  Rtos_GetMutex(pCtx->importMutex);
+
+  if(!pImport->vaddr)
+    pImport->vaddr = LinuxDma_Map(pImport->fd, pImport->size, 0);
+
+  AL_VADDR vaddr = pImport->vaddr;
+  Rtos_ReleaseMutex(pCtx->importMutex);
 
-  if(vaddr == MAP_FAILED)
-  {
-    perror("MAP_FAILED");
-    return NULL;
-  }
   return vaddr;
 }
 
 /******************************************************************************/
 static AL_VADDR LinuxDma_GetVirtualAddr(AL_TAllocator* pAllocator, AL_HANDLE hBuf)
 {
-  (void)pAllocator;
   struct DmaBuffer* pDmaBuffer = (struct DmaBuffer*)hBuf;
 
   if(!pDmaBuffer)
     return NULL;
 
-  if(!pDmaBuffer->vaddr)
+  if(pDmaBuffer->vaddr)
+    return pDmaBuffer->vaddr;
+
+  /* a cached handle only uses the mapping of its import, which Free doesn't unmap */
+  if(pDmaBuffer->pImport)
+    pDmaBuffer->vaddr = GetImportVirtualAddr((struct LinuxDmaCtx*)pAllocator, pDmaBuffer->pImport);
+  else
     pDmaBuffer->vaddr = LinuxDma_Map(pDmaBuffer->info.fd, pDmaBuffer->info.size, pDmaBuffer->mmap_offset);
 
   return (AL_VADDR)pDmaBuffer->vaddr;
@@ -147,6 +294,14 @@ static AL_PADDR LinuxDma_GetPhysicalAddr(AL_TAllocator* pAllocator, AL_HANDLE hB
 static bool LinuxDma_Destroy(AL_TAllocator* pAllocator)
 {
   struct LinuxDmaCtx* pCtx = (struct LinuxDmaCtx*)pAllocator;
+
+  for(int i = 0; i < MAX_IMPORT_CACHE; ++i)
+  {
+    if(pCtx->imports[i].fd >= 0)
+      DropImport(&pCtx->imports[i]);
+  }
+
+  Rtos_DeleteMutex(pCtx->importMutex);
   AL_DevicePool_Close(pCtx->fd);
   free(pCtx);
   return true;
@@ -166,13 +321,26 @@ static AL_TAllocator* create(const char* deviceFile, void const* vtable)
     goto fail_open;
 
   strncpy(pCtx->deviceFile, deviceFile, MAX_DEVICE_FILE_NAME);
+
+  pCtx->importMutex = Rtos_CreateMutex();
+
+  if(!pCtx->importMutex)
+    goto fail_open;
+
   pCtx->fd = AL_DevicePool_Open(deviceFile);
 
   if(pCtx->fd < 0)
-    goto fail_open;
+    goto fail_device;
+
+  pCtx->importCacheState = IMPORT_CACHE_UNKNOWN;
+
+  for(int i = 0; i < MAX_IMPORT_CACHE; ++i)
+    pCtx->imports[i].fd = -1;
 
   return (AL_TAllocator*)pCtx;
 
+  fail_device:
+  Rtos_DeleteMutex(pCtx->importMutex);
   fail_open:
   free(pCtx);
   return NULL;
@@ -224,7 +392,12 @@ static AL_HANDLE LinuxDma_Alloc(AL_TAllocator* pAllocator, size_t zSize)
   pDmaBuffer->info.size = zMapSize;
 
   if(!LinuxDma_GetDmaFd(pAllocator, &pDmaBuffer->info))
-    goto fail;
+  {
+    FlushIdleImports((struct LinuxDmaCtx*)pAllocator);
+
+    if(!LinuxDma_GetDmaFd(pAllocator, &pDmaBuffer->info))
+      goto fail;
+  }
 
   pDmaBuffer->vaddr = NULL;
   pDmaBuffer->offset = 0;
@@ -313,8 +486,143 @@ static size_t LinuxDma_GetDmabufSize(int fd)
   return zSize;
 }
 
+#define DMA_BUF_MAGIC 0x444d4142
+
+/* Older kernels give all the dmabufs the same anonymous inode. They can only
+ * be told apart by their inode number when they live in their own filesystem */
+static bool IsImportCacheEnabled(struct LinuxDmaCtx* pCtx, int fd)
+{
+  if(pCtx->importCacheState == IMPORT_CACHE_UNKNOWN)
+  {
+    struct statfs fsInfo;
+    bool bDmabufFs = (fstatfs(fd, &fsInfo) == 0) && (fsInfo.f_type == DMA_BUF_MAGIC);
+    pCtx->importCacheState = bDmabufFs ? IMPORT_CACHE_ENABLED : IMPORT_CACHE_DISABLED;
+  }
+
+  return pCtx->importCacheState == IMPORT_CACHE_ENABLED;
+}
+
+/* returns a free slot, or the least recently used import without any live
+ * handle. Slots never move: live handles point into the table */
+static struct DmaImport* GetFreeImport(struct LinuxDmaCtx* pCtx)
+{
+  for(int i = 0; i < MAX_IMPORT_CACHE; ++i)
+  {
+    if(pCtx->imports[i].fd < 0)
+      return &pCtx->imports[i];
+  }
+
+  struct DmaImport* pOldest = GetOldestIdleImport(pCtx);
+
+  if(pOldest)
+    DropImport(pOldest);
+
+  return pOldest;
+}
+
+static struct DmaImport* FindImport(struct LinuxDmaCtx* pCtx, struct stat const* pStat)
+{
+  for(int i = 0; i < MAX_IMPORT_CACHE; ++i)
+  {
+    struct DmaImport* pImport = &pCtx->imports[i];
+
+    if(pImport->fd >= 0 && pImport->ino == pStat->st_ino && pImport->dev == pStat->st_dev)
+      return pImport;
+  }
+
+  return NULL;
+}
+
+/* Should be called with the import mutex held. Returns NULL if the dmabuf
+ * isn't in the cache and there is no room to add it */
+static struct DmaImport* GetImport(struct LinuxDmaCtx* pCtx, int fd, struct stat const* pStat)
+{
+  struct DmaImport* pImport = FindImport(pCtx, pStat);
+
+  if(pImport)
+    return pImport;
+
+  pImport = GetFreeImport(pCtx);
+
+  if(!pImport)
+    return NULL;
+
+  struct al5_dma_info info = { 0 };
+  info.fd = fd;
+
+  if(!LinuxDma_GetBusAddrFromFd((AL_TLinuxDmaAllocator*)pCtx, &info))
+    return NULL;
+
+  size_t zMapSize = AlignToPageSize(LinuxDma_GetDmabufSize(fd));
+
+  if(zMapSize == 0)
+    return NULL;
+
+  int cacheFd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+  if(cacheFd < 0)
+    return NULL;
+
+  pImport->dev = pStat->st_dev;
+  pImport->ino = pStat->st_ino;
+  pImport->fd = cacheFd;
+  pImport->phy_addr = info.phy_addr;
+  pImport->size = zMapSize;
+  pImport->vaddr = NULL;
+  pImport->refCount = 0;
+
+  return pImport;
+}
+
+static struct DmaBuffer* ImportFromCache(struct LinuxDmaCtx* pCtx, int fd)
+{
+  struct stat fdStat;
+
+  if(fstat(fd, &fdStat) != 0)
+    return NULL;
+
+  struct DmaBuffer* pDmaBuffer = (struct DmaBuffer*)calloc(1, sizeof(*pDmaBuffer));
+
+  if(!pDmaBuffer)
+    return NULL;
+
+  Rtos_GetMutex(pCtx->importMutex);
+  TrimImports(pCtx, MAX_IMPORT_CACHE_IDLE_SIZE);
+  struct DmaImport* pImport = GetImport(pCtx, fd, &fdStat);
+
+  if(pImport)
+  {
+    ++pImport->refCount;
+    pImport->lastUse = ++pCtx->importClock;
+  }
+  Rtos_ReleaseMutex(pCtx->importMutex);
+
+  if(!pImport)
+  {
+    free(pDmaBuffer);
+    return NULL;
+  }
+
+  pDmaBuffer->info.fd = fd;
+  pDmaBuffer->info.phy_addr = pImport->phy_addr;
+  pDmaBuffer->info.size = pImport->size;
+  pDmaBuffer->pImport = pImport;
+
+  return pDmaBuffer;
+}
+
 static AL_HANDLE LinuxDma_ImportFromFd(AL_TLinuxDmaAllocator* pAllocator, int fd)
 {
+  struct LinuxDmaCtx* pCtx = (struct LinuxDmaCtx*)pAllocator;
+
+  if(IsImportCacheEnabled(pCtx, fd))
+  {
+    struct DmaBuffer* pCached = ImportFromCache(pCtx, fd);
+
+    if(pCached)
+      return pCached;
+  }
+
   struct DmaBuffer* pDmaBuffer = (struct DmaBuffer*)calloc(1, sizeof(*pDmaBuffer));
 
   if(!pDmaBuffer)
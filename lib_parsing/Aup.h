@@ -39,6 +39,7 @@
 
 #include "lib_common/SPS.h"
 #include "lib_common/PPS.h"
+#include "ParamSetMemo.h"
 
 #define AL_MAX_VPS 16
 
@@ -50,6 +51,15 @@ typedef struct
   AL_THevcVps pVPS[AL_MAX_VPS];      // Holds received VPSs.
   AL_THevcSps* pActiveSPS;          // Holds only the currently active SPS.
 
+  // Parameter set memoization
+  AL_TParamSetMemo pPpsMemo[AL_HEVC_MAX_PPS];
+  AL_TParamSetMemo pSpsMemo[AL_HEVC_MAX_SPS];
+  AL_TParamSetMemo pVpsMemo[AL_MAX_VPS];
+  AL_TParamSetIndex PpsIndex;
+  AL_TParamSetIndex SpsIndex;
+  AL_TParamSetIndex VpsIndex;
+  uint32_t uSpsGeneration; // Changes each time a SPS slot is overwritten
+
   AL_EPicStruct ePicStruct;
   int iRecoveryCnt;
 }AL_THevcAup;
@@ -61,6 +71,13 @@ typedef struct
   AL_TAvcPps pPPS[AL_AVC_MAX_PPS]; // Holds all already received PPSs.
   AL_TAvcSps* pActiveSPS;    // Holds only the currently active ParserSPS.
 
+  // Parameter set memoization
+  AL_TParamSetMemo pSpsMemo[AL_AVC_MAX_SPS];
+  AL_TParamSetMemo pPpsMemo[AL_AVC_MAX_PPS];
+  AL_TParamSetIndex SpsIndex;
+  AL_TParamSetIndex PpsIndex;
+  uint32_t uSpsGeneration; // Changes each time a SPS slot is overwritten
+
   AL_ESliceType ePictureType;
   int iRecoveryCnt;
 }AL_TAvcAup;
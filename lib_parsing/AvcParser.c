@@ -50,11 +50,28 @@ static void initPps(AL_TAvcPps* pPPS)
   pPPS->bConceal = true;
 }
 
+static bool isPpsMemoUpToDate(AL_TAvcAup const* aup, int iPpsId)
+{
+  AL_TAvcPps const* pPPS = &aup->pPPS[iPpsId];
+
+  // the PPS derives some of its variables from its SPS
+  return !pPPS->bConceal && !pPPS->pSPS->bConceal && aup->pPpsMemo[iPpsId].uSpsGeneration == aup->uSpsGeneration;
+}
+
 AL_PARSE_RESULT AL_AVC_ParsePPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 {
+  AL_TAvcAup* aup = &pIAup->avcAup;
   uint16_t pps_id, QpBdOffset;
   AL_TAvcPps tempPPS;
 
+  uint32_t uNalSize;
+  uint64_t uNalHash = nal_hash(pRP, &uNalSize);
+  int iMemoId = AL_ParamSetMemo_Find(&aup->PpsIndex, aup->pPpsMemo, uNalHash, uNalSize);
+
+  // byte-identical resent PPS: the slot already holds the result of its parsing
+  if(iMemoId >= 0 && isPpsMemoUpToDate(aup, iMemoId))
+    return AL_OK;
+
   while(u(pRP, 8) == 0x00)
     ; // Skip all 0x00s and one 0x01
 
@@ -262,6 +279,11 @@ AL_PARSE_RESULT AL_AVC_ParsePPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
   COMPLY(tempPPS.num_slice_groups_minus1 == 0); // baseline profile only
 
   pIAup->avcAup.pPPS[pps_id] = tempPPS;
+
+  if(tempPPS.bConceal)
+    AL_ParamSetMemo_Forget(&aup->pPpsMemo[pps_id]);
+  else
+    AL_ParamSetMemo_Store(&aup->PpsIndex, aup->pPpsMemo, pps_id, uNalHash, uNalSize, aup->uSpsGeneration);
   return AL_OK;
 }
 
@@ -306,8 +328,17 @@ static bool isProfileSupported(uint8_t profile_idc)
 
 AL_PARSE_RESULT AL_AVC_ParseSPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 {
+  AL_TAvcAup* aup = &pIAup->avcAup;
   AL_TAvcSps tempSPS;
 
+  uint32_t uNalSize;
+  uint64_t uNalHash = nal_hash(pRP, &uNalSize);
+  int iMemoId = AL_ParamSetMemo_Find(&aup->SpsIndex, aup->pSpsMemo, uNalHash, uNalSize);
+
+  // byte-identical resent SPS: the slot already holds the result of its parsing
+  if(iMemoId >= 0 && !aup->pSPS[iMemoId].bConceal)
+    return AL_OK;
+
   memset(&tempSPS, 0, sizeof(AL_TAvcSps));
 
   // Parse bitstream
@@ -475,6 +506,8 @@ AL_PARSE_RESULT AL_AVC_ParseSPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
   tempSPS.bConceal = false;
 
   pIAup->avcAup.pSPS[sps_id] = tempSPS;
+  ++aup->uSpsGeneration;
+  AL_ParamSetMemo_Store(&aup->SpsIndex, aup->pSpsMemo, sps_id, uNalHash, uNalSize, aup->uSpsGeneration);
   return AL_OK;
 }
 
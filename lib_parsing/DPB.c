@@ -110,6 +110,98 @@ static void DispFifo_SetStatus(AL_TDispFifo* fifo, uint8_t uFrmID, AL_EPicStatus
   fifo->pFrmStatus[uFrmID] = eStatus;
 }
 
+static_assert((DPB_INDEX_SIZE & (DPB_INDEX_SIZE - 1)) == 0 && DPB_INDEX_SIZE >= 2 * MAX_DPB_SIZE, "DPB index size must be a power of 2 larger than twice the dpb size");
+
+static int DpbIndex_Home(int32_t iKey)
+{
+  return (int)(((uint32_t)iKey * 0x9E3779B1u) >> 16) & (DPB_INDEX_SIZE - 1);
+}
+
+static void DpbIndex_Init(AL_TDpbIndex* pIndex)
+{
+  for(int i = 0; i < DPB_INDEX_SIZE; ++i)
+    pIndex->pNodes[i] = uEndOfList;
+}
+
+static void DpbIndex_Add(AL_TDpbIndex* pIndex, int32_t iKey, uint8_t uNode)
+{
+  int iSlot = DpbIndex_Home(iKey);
+
+  while(pIndex->pNodes[iSlot] != uEndOfList)
+    iSlot = (iSlot + 1) & (DPB_INDEX_SIZE - 1);
+
+  pIndex->pKeys[iSlot] = iKey;
+  pIndex->pNodes[iSlot] = uNode;
+}
+
+static void DpbIndex_Remove(AL_TDpbIndex* pIndex, int32_t iKey, uint8_t uNode)
+{
+  int iSlot = DpbIndex_Home(iKey);
+
+  while(pIndex->pNodes[iSlot] != uNode)
+  {
+    if(pIndex->pNodes[iSlot] == uEndOfList)
+      return;
+    iSlot = (iSlot + 1) & (DPB_INDEX_SIZE - 1);
+  }
+
+  // backward shift deletion: keep every remaining entry reachable from its home slot
+  int iNext = iSlot;
+
+  while(true)
+  {
+    iNext = (iNext + 1) & (DPB_INDEX_SIZE - 1);
+
+    if(pIndex->pNodes[iNext] == uEndOfList)
+      break;
+
+    int iHome = DpbIndex_Home(pIndex->pKeys[iNext]);
+    bool bCanMove = (iSlot <= iNext) ? (iHome <= iSlot || iHome > iNext) : (iHome <= iSlot && iHome > iNext);
+
+    if(bCanMove)
+    {
+      pIndex->pKeys[iSlot] = pIndex->pKeys[iNext];
+      pIndex->pNodes[iSlot] = pIndex->pNodes[iNext];
+      iSlot = iNext;
+    }
+  }
+
+  pIndex->pNodes[iSlot] = uEndOfList;
+}
+
+/* Returns the next node stored with iKey, starting the probe at *pSlot (initialized with DpbIndex_Home) */
+static uint8_t DpbIndex_Next(AL_TDpbIndex const* pIndex, int32_t iKey, int* pSlot)
+{
+  while(pIndex->pNodes[*pSlot] != uEndOfList)
+  {
+    int iSlot = *pSlot;
+    *pSlot = (iSlot + 1) & (DPB_INDEX_SIZE - 1);
+
+    if(pIndex->pKeys[iSlot] == iKey)
+      return pIndex->pNodes[iSlot];
+  }
+
+  return uEndOfList;
+}
+
+/*****************************************************************************/
+static void AL_Dpb_sIndexNode(AL_TDpb* pDpb, uint8_t uNode)
+{
+  AL_TDpbNode const* pNode = &pDpb->Nodes[uNode];
+  DpbIndex_Add(&pDpb->PocIndex, pNode->iFramePOC, uNode);
+  DpbIndex_Add(&pDpb->PocLsbIndex, (int32_t)pNode->slice_pic_order_cnt_lsb, uNode);
+  DpbIndex_Add(&pDpb->FrmIDIndex, pNode->uFrmID, uNode);
+}
+
+/*****************************************************************************/
+static void AL_Dpb_sUnindexNode(AL_TDpb* pDpb, uint8_t uNode)
+{
+  AL_TDpbNode const* pNode = &pDpb->Nodes[uNode];
+  DpbIndex_Remove(&pDpb->PocIndex, pNode->iFramePOC, uNode);
+  DpbIndex_Remove(&pDpb->PocLsbIndex, (int32_t)pNode->slice_pic_order_cnt_lsb, uNode);
+  DpbIndex_Remove(&pDpb->FrmIDIndex, pNode->uFrmID, uNode);
+}
+
 /*****************************************************************************/
 static void AL_Dpb_sResetWaiting(AL_TDpb* pDpb)
 {
@@ -387,7 +479,9 @@ static void AL_Dpb_sSetAllPicAsUnused(AL_TDpb* pDpb, AL_TAvcSliceHdr* pSlice)
     uPic = uNext;
   }
 
+  DpbIndex_Remove(&pDpb->PocIndex, pNodes[iCurRef].iFramePOC, iCurRef);
   pNodes[iCurRef].iFramePOC = 0;
+  DpbIndex_Add(&pDpb->PocIndex, 0, iCurRef);
   pNodes[iCurRef].iSlice_frame_num = 0;
   pNodes[iCurRef].eNUT = AL_HEVC_NUT_ERR;
   pDpb->MaxLongTermFrameIdx = 0x7FFF;
@@ -558,8 +652,13 @@ void AL_Dpb_Init(AL_TDpb* pDpb, uint8_t uNumRef, AL_EDpbMode eMode, AL_TDpbCallb
 
   pDpb->uHeadDecOrder = uEndOfList;
   pDpb->uHeadPOC = uEndOfList;
+  pDpb->uHeadPocLsb = uEndOfList;
   pDpb->uLastPOC = uEndOfList;
 
+  DpbIndex_Init(&pDpb->PocIndex);
+  DpbIndex_Init(&pDpb->PocLsbIndex);
+  DpbIndex_Init(&pDpb->FrmIDIndex);
+
   pDpb->uCountRef = 0;
   pDpb->uCountPic = 0;
   pDpb->uCurRef = 0;
@@ -813,44 +912,98 @@ void AL_Dpb_FillList(AL_TDpb* pDpb, uint8_t uL0L1, TBufferListRef const* pListRe
 }
 
 /*************************************************************************/
-uint8_t AL_Dpb_SearchPocLsb(AL_TDpb* pDpb, uint32_t poc_lsb)
+static bool AL_Dpb_sIsPocLsbCandidate(AL_TDpbNode const* pNode)
 {
-  DPB_GET_MUTEX(pDpb);
+  return pNode->eMarking_flag != UNUSED_FOR_REF;
+}
 
+/*************************************************************************/
+static uint8_t AL_Dpb_sSearchPocLsbInList(AL_TDpb* pDpb, uint32_t poc_lsb)
+{
   uint8_t uParse = pDpb->uHeadPocLsb;
 
   while(uParse != uEndOfList)
   {
-    if(pDpb->Nodes[uParse].slice_pic_order_cnt_lsb == poc_lsb && pDpb->Nodes[uParse].eMarking_flag != UNUSED_FOR_REF)
+    if(pDpb->Nodes[uParse].slice_pic_order_cnt_lsb == poc_lsb && AL_Dpb_sIsPocLsbCandidate(&pDpb->Nodes[uParse]))
       break;
     else
       uParse = pDpb->Nodes[uParse].uNextPocLsb;
   }
 
-  DPB_RELEASE_MUTEX(pDpb);
   return uParse;
 }
 
-/*****************************************************************************/
-uint8_t AL_Dpb_SearchPOC(AL_TDpb* pDpb, int iPOC)
+/*************************************************************************/
+uint8_t AL_Dpb_SearchPocLsb(AL_TDpb* pDpb, uint32_t poc_lsb)
 {
   DPB_GET_MUTEX(pDpb);
 
+  int iSlot = DpbIndex_Home((int32_t)poc_lsb);
+  uint8_t uFound = uEndOfList;
+  uint8_t uNode;
+  int iNumFound = 0;
+
+  while((uNode = DpbIndex_Next(&pDpb->PocLsbIndex, (int32_t)poc_lsb, &iSlot)) != uEndOfList)
+  {
+    if(AL_Dpb_sIsPocLsbCandidate(&pDpb->Nodes[uNode]) && iNumFound++ == 0)
+      uFound = uNode;
+  }
+
+  // several candidates: the first one in poc_lsb order wins
+  if(iNumFound > 1)
+    uFound = AL_Dpb_sSearchPocLsbInList(pDpb, poc_lsb);
+
+  DPB_RELEASE_MUTEX(pDpb);
+  return uFound;
+}
+
+/*****************************************************************************/
+static bool AL_Dpb_sIsPocCandidate(AL_TDpbNode const* pNode)
+{
+  return pNode->eMarking_flag != UNUSED_FOR_REF && !pNode->non_existing;
+}
+
+/*****************************************************************************/
+static uint8_t AL_Dpb_sSearchPOCInList(AL_TDpb* pDpb, int iPOC)
+{
   uint8_t uParse = pDpb->uHeadPOC;
   AL_TDpbNode* pNodes = pDpb->Nodes;
 
   while(uParse != uEndOfList)
   {
-    if(pNodes[uParse].iFramePOC == iPOC && pNodes[uParse].eMarking_flag != UNUSED_FOR_REF && !pNodes[uParse].non_existing)
+    if(pNodes[uParse].iFramePOC == iPOC && AL_Dpb_sIsPocCandidate(&pNodes[uParse]))
       break;
     else
       uParse = pDpb->Nodes[uParse].uNextPOC;
   }
 
-  DPB_RELEASE_MUTEX(pDpb);
   return uParse;
 }
 
+/*****************************************************************************/
+uint8_t AL_Dpb_SearchPOC(AL_TDpb* pDpb, int iPOC)
+{
+  DPB_GET_MUTEX(pDpb);
+
+  int iSlot = DpbIndex_Home(iPOC);
+  uint8_t uFound = uEndOfList;
+  uint8_t uNode;
+  int iNumFound = 0;
+
+  while((uNode = DpbIndex_Next(&pDpb->PocIndex, iPOC, &iSlot)) != uEndOfList)
+  {
+    if(AL_Dpb_sIsPocCandidate(&pDpb->Nodes[uNode]) && iNumFound++ == 0)
+      uFound = uNode;
+  }
+
+  // several candidates: the first one in POC order wins
+  if(iNumFound > 1)
+    uFound = AL_Dpb_sSearchPOCInList(pDpb, iPOC);
+
+  DPB_RELEASE_MUTEX(pDpb);
+  return uFound;
+}
+
 /*****************************************************************************/
 void AL_Dpb_Display(AL_TDpb* pDpb, uint8_t uNode)
 {
@@ -1095,6 +1248,7 @@ uint8_t AL_Dpb_Remove(AL_TDpb* pDpb, uint8_t uNode)
   RemoveFromPocList(pDpb, uNode);
   RemoveFromPocLsbList(pDpb, uNode);
   RemoveFromDecOrderList(pDpb, uNode);
+  AL_Dpb_sUnindexNode(pDpb, uNode);
 
   // Release node
   AL_Dpb_sReleasePicID(pDpb, pNode->uPicID);
@@ -1274,6 +1428,8 @@ void AL_Dpb_Insert(AL_TDpb* pDpb, int iFramePOC, uint32_t uPocLsb, uint8_t uNode
     pDpb->Nodes[uCurDecOrder].uNextDecOrder = uNode;
   }
 
+  AL_Dpb_sIndexNode(pDpb, uNode);
+
   // Update List counters
   if(eMarkingFlag != UNUSED_FOR_REF)
     ++pDpb->uCountRef;
@@ -1301,17 +1457,29 @@ static bool AL_Dpb_sIsLowRef(AL_TDpb* pDpb)
 /*****************************************************************************/
 static uint8_t Dpb_GetNodeFromFrmID(AL_TDpb* pDpb, int iFrameID)
 {
-  AL_TDpbNode const* pNodes = pDpb->Nodes;
-  uint8_t uNode = pDpb->uHeadDecOrder;
+  int iSlot = DpbIndex_Home(iFrameID);
+  uint8_t uFound = uEndOfList;
+  uint8_t uNode;
 
-  while(uNode != uEndOfList)
+  // a frame buffer is held by a single node, keep the first one in decoding order otherwise
+  while((uNode = DpbIndex_Next(&pDpb->FrmIDIndex, iFrameID, &iSlot)) != uEndOfList)
   {
-    if(pNodes[uNode].uFrmID == iFrameID)
+    if(uFound != uEndOfList)
+    {
+      uFound = uEndOfList;
+
+      for(uNode = pDpb->uHeadDecOrder; uNode != uEndOfList; uNode = pDpb->Nodes[uNode].uNextDecOrder)
+      {
+        if(pDpb->Nodes[uNode].uFrmID == iFrameID)
+          return uNode;
+      }
+
       break;
-    uNode = pNodes[uNode].uNextDecOrder;
+    }
+    uFound = uNode;
   }
 
-  return uNode;
+  return uFound;
 }
 
 /*****************************************************************************/
@@ -68,6 +68,8 @@
 #define uEndOfList 0xFF /*!< End Of List marker for Reference List */
 #define UndefID 0xFF/*!< Unused Buffer ID*/
 
+#define DPB_INDEX_SIZE 128 /*!< Number of slots of a DPB node index (power of 2, at least twice MAX_DPB_SIZE) */
+
 /*************************************************************************//*!
    \brief Picture status enum
 *****************************************************************************/
@@ -149,6 +151,16 @@ typedef struct t_DpbNode
   AL_ENut eNUT;
 }AL_TDpbNode;
 
+/*************************************************************************//*!
+   \brief Open-addressing index (linear probing) from a key to DPB nodes.
+   Several nodes can share the same key.
+*****************************************************************************/
+typedef struct t_DpbIndex
+{
+  int32_t pKeys[DPB_INDEX_SIZE];
+  uint8_t pNodes[DPB_INDEX_SIZE]; /*!< Node stored in each slot, uEndOfList when the slot is free */
+}AL_TDpbIndex;
+
 /*************************************************************************//*!
    \ingroup RefPool
    \brief Reference Buffers Pool object
@@ -195,6 +207,10 @@ typedef struct t_DPB
   uint8_t uLastPOC;      /*!< Index of the last node in POC order      */
   uint8_t uHeadDecOrder; /*!< Index of the first node in arrival order */
 
+  AL_TDpbIndex PocIndex;    /*!< Nodes indexed by POC */
+  AL_TDpbIndex PocLsbIndex; /*!< Nodes indexed by poc_lsb (long term reference lookup) */
+  AL_TDpbIndex FrmIDIndex;  /*!< Nodes indexed by frame buffer ID */
+
   /*decoding members*/
   uint8_t uCurRef;
   uint8_t uCountRef;            /*!< Number of used node in the reference list */
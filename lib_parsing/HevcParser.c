@@ -67,6 +67,15 @@ static void initPps(AL_THevcPps* pPPS)
   pPPS->log2_sao_offset_scale_chroma = 0;
 }
 
+/*****************************************************************************/
+static bool isPpsMemoUpToDate(AL_THevcAup const* aup, int iPpsId)
+{
+  AL_THevcPps const* pPPS = &aup->pPPS[iPpsId];
+
+  // the PPS derives some of its variables from its SPS
+  return !pPPS->bConceal && !pPPS->pSPS->bConceal && aup->pPpsMemo[iPpsId].uSpsGeneration == aup->uSpsGeneration;
+}
+
 /*****************************************************************************/
 void AL_HEVC_ParsePPS(AL_TAup* pIAup, AL_TRbspParser* pRP, uint8_t* pPpsId)
 {
@@ -75,6 +84,17 @@ void AL_HEVC_ParsePPS(AL_TAup* pIAup, AL_TRbspParser* pRP, uint8_t* pPpsId)
   uint16_t uLCUWidth, uLCUHeight;
   AL_THevcPps* pPPS;
 
+  uint32_t uNalSize;
+  uint64_t uNalHash = nal_hash(pRP, &uNalSize);
+  int iMemoId = AL_ParamSetMemo_Find(&aup->PpsIndex, aup->pPpsMemo, uNalHash, uNalSize);
+
+  // byte-identical resent PPS: the slot already holds the result of its parsing
+  if(iMemoId >= 0 && isPpsMemoUpToDate(aup, iMemoId))
+  {
+    *pPpsId = iMemoId;
+    return;
+  }
+
   // Parse bitstream
   while(u(pRP, 8) == 0x00)
     ; // Skip all 0x00s and one 0x01
@@ -92,6 +112,8 @@ void AL_HEVC_ParsePPS(AL_TAup* pIAup, AL_TRbspParser* pRP, uint8_t* pPpsId)
   if(pps_id >= AL_HEVC_MAX_PPS)
     return;
 
+  AL_ParamSetMemo_Forget(&aup->pPpsMemo[pps_id]);
+
   pPPS->pps_pic_parameter_set_id = pps_id;
   pPPS->pps_seq_parameter_set_id = ue(pRP);
 
@@ -277,6 +299,9 @@ void AL_HEVC_ParsePPS(AL_TAup* pIAup, AL_TRbspParser* pRP, uint8_t* pPpsId)
   }
 
   pPPS->bConceal = rbsp_trailing_bits(pRP) ? false : true;
+
+  if(!pPPS->bConceal)
+    AL_ParamSetMemo_Store(&aup->PpsIndex, aup->pPpsMemo, pps_id, uNalHash, uNalSize, aup->uSpsGeneration);
 }
 
 /*****************************************************************************/
@@ -423,8 +448,17 @@ static void initSps(AL_THevcSps* pSPS)
 /*****************************************************************************/
 AL_PARSE_RESULT AL_HEVC_ParseSPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 {
+  AL_THevcAup* aup = &pIAup->hevcAup;
   AL_THevcSps tempSPS;
 
+  uint32_t uNalSize;
+  uint64_t uNalHash = nal_hash(pRP, &uNalSize);
+  int iMemoId = AL_ParamSetMemo_Find(&aup->SpsIndex, aup->pSpsMemo, uNalHash, uNalSize);
+
+  // byte-identical resent SPS: the slot already holds the result of its parsing
+  if(iMemoId >= 0 && !aup->pSPS[iMemoId].bConceal)
+    return AL_OK;
+
   // Parse bitstream
   while(u(pRP, 8) == 0x00)
     ; // Skip all 0x00s and one 0x01
@@ -446,6 +480,9 @@ AL_PARSE_RESULT AL_HEVC_ParseSPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 
   COMPLY(sps_id < AL_HEVC_MAX_SPS);
 
+  AL_ParamSetMemo_Forget(&aup->pSpsMemo[sps_id]);
+  ++aup->uSpsGeneration;
+
   tempSPS.bConceal = true;
   tempSPS.sps_video_parameter_set_id = vps_id;
   tempSPS.sps_max_sub_layers_minus1 = max_sub_layers;
@@ -659,6 +696,7 @@ AL_PARSE_RESULT AL_HEVC_ParseSPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 
   tempSPS.bConceal = false;
   pIAup->hevcAup.pSPS[sps_id] = tempSPS;
+  AL_ParamSetMemo_Store(&aup->SpsIndex, aup->pSpsMemo, sps_id, uNalHash, uNalSize, aup->uSpsGeneration);
 
   return AL_OK;
 }
@@ -717,8 +755,16 @@ void AL_HEVC_short_term_ref_pic_set(AL_THevcSps* pSPS, uint8_t RefIdx, AL_TRbspP
 /*****************************************************************************/
 void ParseVPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 {
+  AL_THevcAup* aup = &pIAup->hevcAup;
   AL_THevcVps* pVPS;
 
+  uint32_t uNalSize;
+  uint64_t uNalHash = nal_hash(pRP, &uNalSize);
+
+  // byte-identical resent VPS: the slot already holds the result of its parsing
+  if(AL_ParamSetMemo_Find(&aup->VpsIndex, aup->pVpsMemo, uNalHash, uNalSize) >= 0)
+    return;
+
   // Parse bitstream
   while(u(pRP, 8) == 0x00)
     ; // Skip all 0x00s and one 0x01
@@ -727,6 +773,7 @@ void ParseVPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
 
   int vps_id = u(pRP, 4);
   pVPS = &pIAup->hevcAup.pVPS[vps_id];
+  AL_ParamSetMemo_Forget(&aup->pVpsMemo[vps_id]);
   pVPS->vps_video_parameter_set_id = vps_id;
 
   pVPS->vps_base_layer_internal_flag = u(pRP, 1);
@@ -796,6 +843,8 @@ void ParseVPS(AL_TAup* pIAup, AL_TRbspParser* pRP)
       skip(pRP, 1); // vps_extension_data_flag
   }
   rbsp_trailing_bits(pRP);
+
+  AL_ParamSetMemo_Store(&aup->VpsIndex, aup->pVpsMemo, vps_id, uNalHash, uNalSize, 0);
 }
 
 /*****************************************************************************/
@@ -92,40 +92,104 @@ static bool sRecBuffers_HasBuf(AL_TRecBuffers* tRecBuffers, AL_TBuffer* pBuf, AL
   return bHasBuf;
 }
 
+static_assert(FRM_BUF_POOL_SIZE <= 64, "Frame buffer pool free IDs must fit in a 64 bits bitmap");
+static_assert((FRM_BUF_INDEX_SIZE & (FRM_BUF_INDEX_SIZE - 1)) == 0 && FRM_BUF_INDEX_SIZE >= 2 * FRM_BUF_POOL_SIZE, "Frame buffer index size must be a power of 2 larger than twice the pool size");
+
 /*************************************************************************/
-static int sFrmBufPool_GetFrameIDFromBuf(AL_TFrmBufPool* pPool, AL_TBuffer* pBuf)
+static int sFrmBufIndex_Home(AL_TBuffer const* pBuf)
 {
-  Rtos_GetMutex(pPool->Mutex);
+  uintptr_t uKey = (uintptr_t)pBuf >> 4;
+  return (int)(((uint32_t)(uKey ^ (uKey >> 16)) * 0x9E3779B1u) >> 16) & (FRM_BUF_INDEX_SIZE - 1);
+}
 
-  for(int i = 0; i < FRM_BUF_POOL_SIZE; i++)
+/*************************************************************************/
+static void sFrmBufIndex_Init(AL_TFrmBufPool* pPool)
+{
+  for(int i = 0; i < FRM_BUF_INDEX_SIZE; i++)
   {
-    if(sRecBuffers_HasBuf(&pPool->array[i].tRecBuffers, pBuf, pPool))
-    {
-      Rtos_ReleaseMutex(pPool->Mutex);
-      return i;
-    }
+    pPool->pIndexBufs[i] = NULL;
+    pPool->pIndexIDs[i] = -1;
+  }
+}
+
+/*************************************************************************/
+static void sFrmBufIndex_Add(AL_TFrmBufPool* pPool, AL_TBuffer* pBuf, int iFrameID)
+{
+  int iSlot = sFrmBufIndex_Home(pBuf);
+
+  while(pPool->pIndexBufs[iSlot])
+    iSlot = (iSlot + 1) & (FRM_BUF_INDEX_SIZE - 1);
+
+  pPool->pIndexBufs[iSlot] = pBuf;
+  pPool->pIndexIDs[iSlot] = iFrameID;
+}
+
+/*************************************************************************/
+static int sFrmBufIndex_FindSlot(AL_TFrmBufPool* pPool, AL_TBuffer const* pBuf)
+{
+  int iSlot = sFrmBufIndex_Home(pBuf);
+
+  while(pPool->pIndexBufs[iSlot])
+  {
+    if(pPool->pIndexBufs[iSlot] == pBuf)
+      return iSlot;
+    iSlot = (iSlot + 1) & (FRM_BUF_INDEX_SIZE - 1);
   }
 
-  Rtos_ReleaseMutex(pPool->Mutex);
   return -1;
 }
 
 /*************************************************************************/
-static int sFrmBufPool_GetFrameIDFromDisplay(AL_TFrmBufPool* pPool, AL_TBuffer* pDisplayBuf)
+static void sFrmBufIndex_Remove(AL_TFrmBufPool* pPool, AL_TBuffer const* pBuf)
 {
-  Rtos_GetMutex(pPool->Mutex);
+  int iSlot = sFrmBufIndex_FindSlot(pPool, pBuf);
 
-  for(int i = 0; i < FRM_BUF_POOL_SIZE; i++)
+  if(iSlot == -1)
+    return;
+
+  // backward shift deletion: keep every remaining entry reachable from its home slot
+  int iNext = iSlot;
+
+  while(true)
   {
-    if(sRecBuffers_GetDisplayBuffer(&pPool->array[i].tRecBuffers, pPool) == pDisplayBuf)
+    iNext = (iNext + 1) & (FRM_BUF_INDEX_SIZE - 1);
+
+    if(!pPool->pIndexBufs[iNext])
+      break;
+
+    int iHome = sFrmBufIndex_Home(pPool->pIndexBufs[iNext]);
+    bool bCanMove = (iSlot <= iNext) ? (iHome <= iSlot || iHome > iNext) : (iHome <= iSlot && iHome > iNext);
+
+    if(bCanMove)
     {
-      Rtos_ReleaseMutex(pPool->Mutex);
-      return i;
+      pPool->pIndexBufs[iSlot] = pPool->pIndexBufs[iNext];
+      pPool->pIndexIDs[iSlot] = pPool->pIndexIDs[iNext];
+      iSlot = iNext;
     }
   }
 
+  pPool->pIndexBufs[iSlot] = NULL;
+  pPool->pIndexIDs[iSlot] = -1;
+}
+
+/*************************************************************************/
+static int sFrmBufPool_GetFrameIDFromBuf(AL_TFrmBufPool* pPool, AL_TBuffer* pBuf)
+{
+  Rtos_GetMutex(pPool->Mutex);
+
+  int const iSlot = sFrmBufIndex_FindSlot(pPool, pBuf);
+  int const iFrameID = (iSlot == -1) ? -1 : pPool->pIndexIDs[iSlot];
+  assert(iFrameID == -1 || sRecBuffers_HasBuf(&pPool->array[iFrameID].tRecBuffers, pBuf, pPool));
+
   Rtos_ReleaseMutex(pPool->Mutex);
-  return -1;
+  return iFrameID;
+}
+
+/*************************************************************************/
+static int sFrmBufPool_GetFrameIDFromDisplay(AL_TFrmBufPool* pPool, AL_TBuffer* pDisplayBuf)
+{
+  // the display buffer is the frame buffer itself
+  return sFrmBufPool_GetFrameIDFromBuf(pPool, pDisplayBuf);
 }
 
 /*************************************************************************/
@@ -149,6 +213,8 @@ static bool sFrmBufPoolFifo_IsInFifo(AL_TFrmBufPool* pPool, AL_TBuffer* pDisplay
 static void AddBufferToFifo(AL_TFrmBufPool* pPool, int iFrameID, AL_TRecBuffers tRecBuffers)
 {
   pPool->array[iFrameID].tRecBuffers = tRecBuffers;
+  pPool->uFreeIDs &= ~((uint64_t)1 << iFrameID);
+  sFrmBufIndex_Add(pPool, tRecBuffers.pFrame, iFrameID);
 
   if(pPool->iFifoTail == -1 && pPool->iFifoHead == -1)
     pPool->iFifoHead = iFrameID;
@@ -170,19 +236,19 @@ static void sFrmBufPoolFifo_PushBack(AL_TFrmBufPool* pPool, AL_TRecBuffers tRecB
 
   Rtos_GetMutex(pPool->Mutex);
 
-  for(int i = 0; i < FRM_BUF_POOL_SIZE; i++)
+  int const iFrameID = FindFirstSet64(pPool->uFreeIDs);
+
+  if(iFrameID != -1)
   {
-    if(sRecBuffers_AreNull(&pPool->array[i].tRecBuffers) &&
-       (pPool->array[i].iNext == -1) &&
-       (pPool->array[i].iAccessCnt == -1) &&
-       (pPool->array[i].bWillBeOutputed == false)
-       )
-    {
-      AddBufferToFifo(pPool, i, tRecBuffers);
-      Rtos_SetEvent(pPool->Event);
-      Rtos_ReleaseMutex(pPool->Mutex);
-      return;
-    }
+    assert(sRecBuffers_AreNull(&pPool->array[iFrameID].tRecBuffers) &&
+           (pPool->array[iFrameID].iNext == -1) &&
+           (pPool->array[iFrameID].iAccessCnt == -1) &&
+           (pPool->array[iFrameID].bWillBeOutputed == false));
+
+    AddBufferToFifo(pPool, iFrameID, tRecBuffers);
+    Rtos_SetEvent(pPool->Event);
+    Rtos_ReleaseMutex(pPool->Mutex);
+    return;
   }
 
   Rtos_ReleaseMutex(pPool->Mutex);
@@ -258,7 +324,9 @@ static void sFrmBufPool_RemoveID(AL_TFrmBufPool* pPool, int iFrameID)
   assert(pFrame->iNext == -1);
   assert(pFrame->iAccessCnt == 0);
 
+  sFrmBufIndex_Remove(pPool, pFrame->tRecBuffers.pFrame);
   sRecBuffers_Reset(&pFrame->tRecBuffers);
+  pPool->uFreeIDs |= (uint64_t)1 << iFrameID;
   pFrame->iAccessCnt = -1;
   pFrame->bWillBeOutputed = false;
   pFrame->iNext = -1;
@@ -287,6 +355,8 @@ static void sFrmBufPoolFifo_Init(AL_TFrmBufPool* pPool)
 
   pPool->iFifoHead = -1;
   pPool->iFifoTail = -1;
+  pPool->uFreeIDs = (FRM_BUF_POOL_SIZE == 64) ? UINT64_MAX : (((uint64_t)1 << FRM_BUF_POOL_SIZE) - 1);
+  sFrmBufIndex_Init(pPool);
 }
 
 /*************************************************************************/
@@ -75,11 +75,16 @@ typedef struct
   AL_ERR eError;
 }AL_TFrameFifo;
 
+#define FRM_BUF_INDEX_SIZE 128 /*!< Number of slots of the buffer to frame ID index (power of 2, at least twice FRM_BUF_POOL_SIZE) */
+
 typedef struct t_FrmBufPool
 {
   AL_TFrameFifo array[FRM_BUF_POOL_SIZE];
   int iFifoHead;
   int iFifoTail;
+  uint64_t uFreeIDs; /*!< Bitmap of the unused entries of array */
+  AL_TBuffer* pIndexBufs[FRM_BUF_INDEX_SIZE]; /*!< Open-addressing index from a frame buffer to its ID */
+  int8_t pIndexIDs[FRM_BUF_INDEX_SIZE];
 
   AL_MUTEX Mutex;
   AL_EVENT Event;
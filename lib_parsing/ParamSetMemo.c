@@ -0,0 +1,89 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+#include "ParamSetMemo.h"
+#include "lib_rtos/lib_rtos.h"
+
+/*****************************************************************************/
+static int getBucket(uint64_t uHash)
+{
+  return (int)(uHash >> 32) & (AL_PARAM_SET_MEMO_BUCKETS - 1);
+}
+
+/*****************************************************************************/
+void AL_ParamSetMemo_Init(AL_TParamSetIndex* pIndex, AL_TParamSetMemo* pMemos, int iNumIds)
+{
+  Rtos_Memset(pIndex->pBuckets, 0, sizeof(pIndex->pBuckets));
+
+  for(int i = 0; i < iNumIds; ++i)
+    AL_ParamSetMemo_Forget(&pMemos[i]);
+}
+
+/*****************************************************************************/
+int AL_ParamSetMemo_Find(AL_TParamSetIndex const* pIndex, AL_TParamSetMemo const* pMemos, uint64_t uHash, uint32_t uSize)
+{
+  if(!uHash)
+    return -1;
+
+  int iId = pIndex->pBuckets[getBucket(uHash)] - 1;
+
+  // the bucket only remembers the last stored slot: the slot may since have been overwritten
+  if(iId < 0 || pMemos[iId].uHash != uHash || pMemos[iId].uSize != uSize)
+    return -1;
+
+  return iId;
+}
+
+/*****************************************************************************/
+void AL_ParamSetMemo_Store(AL_TParamSetIndex* pIndex, AL_TParamSetMemo* pMemos, int iId, uint64_t uHash, uint32_t uSize, uint32_t uSpsGeneration)
+{
+  if(!uHash)
+    return;
+
+  pMemos[iId].uHash = uHash;
+  pMemos[iId].uSize = uSize;
+  pMemos[iId].uSpsGeneration = uSpsGeneration;
+  pIndex->pBuckets[getBucket(uHash)] = iId + 1;
+}
+
+/*****************************************************************************/
+void AL_ParamSetMemo_Forget(AL_TParamSetMemo* pMemo)
+{
+  pMemo->uHash = 0;
+  pMemo->uSize = 0;
+}
+
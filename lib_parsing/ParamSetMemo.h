@@ -0,0 +1,99 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/****************************************************************************
+   -----------------------------------------------------------------------------
+ **************************************************************************//*!
+   \addtogroup lib_decode_hls
+   @{
+   \file
+ *****************************************************************************/
+
+#pragma once
+
+#include "lib_rtos/types.h"
+
+#define AL_PARAM_SET_MEMO_BUCKETS 64
+
+/*************************************************************************//*!
+   \brief Identifies the raw NAL a parameter set slot was last parsed from
+*****************************************************************************/
+typedef struct
+{
+  uint64_t uHash; // Content hash of the NAL, 0 when the slot is not memoized
+  uint32_t uSize; // Size in bytes of the hashed NAL
+  uint32_t uSpsGeneration; // SPS generation the slot was parsed against
+}AL_TParamSetMemo;
+
+/*************************************************************************//*!
+   \brief Direct-mapped table from a NAL content hash to a parameter set id
+*****************************************************************************/
+typedef struct
+{
+  uint16_t pBuckets[AL_PARAM_SET_MEMO_BUCKETS]; // id + 1 of the last slot stored in the bucket, 0 if empty
+}AL_TParamSetIndex;
+
+/*************************************************************************//*!
+   \brief Forgets every memoized slot
+   \param[out] pIndex  Hash to id table
+   \param[out] pMemos  Per-id memo array
+   \param[in]  iNumIds Number of entries of pMemos
+*****************************************************************************/
+void AL_ParamSetMemo_Init(AL_TParamSetIndex* pIndex, AL_TParamSetMemo* pMemos, int iNumIds);
+
+/*************************************************************************//*!
+   \brief Looks up the slot holding a parameter set parsed from byte-identical data
+   \param[in] pIndex Hash to id table
+   \param[in] pMemos Per-id memo array
+   \param[in] uHash  Content hash of the NAL, as returned by nal_hash
+   \param[in] uSize  Size of the NAL, as returned by nal_hash
+   \return the id of the matching slot, -1 if there is none
+*****************************************************************************/
+int AL_ParamSetMemo_Find(AL_TParamSetIndex const* pIndex, AL_TParamSetMemo const* pMemos, uint64_t uHash, uint32_t uSize);
+
+/*************************************************************************//*!
+   \brief Remembers that slot iId now holds the parameter set parsed from the hashed NAL
+*****************************************************************************/
+void AL_ParamSetMemo_Store(AL_TParamSetIndex* pIndex, AL_TParamSetMemo* pMemos, int iId, uint64_t uHash, uint32_t uSize, uint32_t uSpsGeneration);
+
+/*************************************************************************//*!
+   \brief Forgets the slot content, to be called before the slot is overwritten
+*****************************************************************************/
+void AL_ParamSetMemo_Forget(AL_TParamSetMemo* pMemo);
+
+/*@}*/
+
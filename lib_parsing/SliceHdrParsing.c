@@ -510,14 +510,10 @@ static void AL_HEVC_sReadWPCoeff(AL_TRbspParser* pRP, AL_THevcSliceHdr* pSlice,
   uint8_t uNumRefIdx = uL0L1 ? pSlice->num_ref_idx_l1_active_minus1 : pSlice->num_ref_idx_l0_active_minus1;
   AL_TWPCoeff* pWpCoeff = &pSlice->pred_weight_table.tWpCoeff[uL0L1];
 
-  for(uint8_t i = 0; i <= uNumRefIdx; i++)
-    pWpCoeff->luma_weight_flag[i] = u(pRP, 1);
+  u_flags(pRP, pWpCoeff->luma_weight_flag, uNumRefIdx + 1);
 
   if(pSlice->pSPS->ChromaArrayType)
-  {
-    for(uint8_t i = 0; i <= uNumRefIdx; i++)
-      pWpCoeff->chroma_weight_flag[i] = u(pRP, 1);
-  }
+    u_flags(pRP, pWpCoeff->chroma_weight_flag, uNumRefIdx + 1);
 
   for(uint8_t i = 0; i <= uNumRefIdx; i++)
   {
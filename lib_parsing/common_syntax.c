@@ -57,8 +57,7 @@ void profile_tier_level(AL_TProfilevel* pPrfLvl, int iMaxSubLayers, AL_TRbspPars
   pPrfLvl->general_tier_flag = u(pRP, 1);
   pPrfLvl->general_profile_idc = u(pRP, 5);
 
-  for(int i = 0; i < 32; ++i)
-    pPrfLvl->general_profile_compatibility_flag[i] = u(pRP, 1);
+  u_flags(pRP, pPrfLvl->general_profile_compatibility_flag, 32);
 
   pPrfLvl->general_progressive_source_flag = u(pRP, 1);
   pPrfLvl->general_interlaced_source_flag = u(pRP, 1);
@@ -104,8 +103,7 @@ void profile_tier_level(AL_TProfilevel* pPrfLvl, int iMaxSubLayers, AL_TRbspPars
       pPrfLvl->sub_layer_tier_flag[i] = u(pRP, 1);
       pPrfLvl->sub_layer_profile_idc[i] = u(pRP, 5);
 
-      for(int j = 0; j < 32; ++j)
-        pPrfLvl->sub_layer_profile_compatibility_flag[i][j] = u(pRP, 1);
+      u_flags(pRP, pPrfLvl->sub_layer_profile_compatibility_flag[i], 32);
 
       pPrfLvl->sub_layer_progressive_source_flag[i] = u(pRP, 1);
       pPrfLvl->sub_layer_interlaced_source_flag[i] = u(pRP, 1);
@@ -1,5 +1,6 @@
 LIB_PARSING_SRC:=\
 	lib_parsing/common_syntax.c\
+	lib_parsing/ParamSetMemo.c\
 	lib_parsing/AvcParser.c\
 	lib_parsing/HevcParser.c\
 	lib_parsing/SliceHdrParsing.c\
@@ -35,6 +35,10 @@
 *
 ******************************************************************************/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* thread affinity and names */
+#endif
+
 #include "lib_rtos/lib_rtos.h"
 
 #ifndef ENABLE_RTOS_SYNC
@@ -218,12 +222,33 @@ static HANDLE GetNative(AL_THREAD Thread)
 
 /****************************************************************************/
 AL_THREAD Rtos_CreateThread(void* (*pFunc)(void* pParam), void* pParam)
+{
+  return Rtos_CreateThreadWithAttr(pFunc, pParam, NULL);
+}
+
+/****************************************************************************/
+AL_THREAD Rtos_CreateThreadWithAttr(void* (*pFunc)(void* pParam), void* pParam, AL_TThreadAttr const* pAttr)
 {
   HANDLE* pThread = Rtos_Malloc(sizeof(HANDLE));
   DWORD id;
 
-  if(pThread)
-    *pThread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)pFunc, pParam, 0, &id);
+  if(!pThread)
+    return NULL;
+
+  *pThread = CreateThread(NULL, pAttr ? pAttr->zStackSize : 0, (LPTHREAD_START_ROUTINE)pFunc, pParam, 0, &id);
+
+  if(!*pThread)
+  {
+    Rtos_Free(pThread);
+    return NULL;
+  }
+
+  if(pAttr && pAttr->uAffinityMask)
+    SetThreadAffinityMask(*pThread, (DWORD_PTR)pAttr->uAffinityMask);
+
+  if(pAttr && pAttr->iPriority)
+    SetThreadPriority(*pThread, THREAD_PRIORITY_TIME_CRITICAL);
+
   return pThread;
 }
 
@@ -277,15 +302,161 @@ int Rtos_DriverPoll(void* drv, int timeout)
 #include <unistd.h>
 
 #include <pthread.h>
-#include <semaphore.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <assert.h>
+
+/* Mutexes, semaphores and events are built directly on futexes: taking or
+ * giving them without contention is a single atomic operation, the kernel
+ * is only entered to sleep or to wake a sleeping thread. */
+
+#define MAX_SPIN 100
 
 typedef struct
 {
-  pthread_mutex_t Mutex;
-  pthread_cond_t Cond;
-  bool bSignaled;
+  int32_t iState; /* MUTEX_xxx */
+  uintptr_t uOwner; /* thread id of the owner, 0 if free */
+  int32_t iRecursion;
+  int32_t iSpin; /* adaptive spin count, learned from previous lock attempts */
+}mtx_t;
+
+enum
+{
+  MUTEX_FREE,
+  MUTEX_LOCKED,
+  MUTEX_CONTENDED, /* locked, and there might be threads sleeping on it */
+};
+
+typedef struct
+{
+  int32_t iCount;
+  int32_t iNumWaiters;
+}sem_ctx_t;
+
+typedef struct
+{
+  int32_t iSignaled;
+  int32_t iNumWaiters;
 }evt_t;
 
+/* the address of a thread local variable identifies the thread without a syscall */
+static __thread char tThreadMarker;
+
+/****************************************************************************/
+static uintptr_t GetThreadId()
+{
+  return (uintptr_t)&tThreadMarker;
+}
+
+/****************************************************************************/
+static inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__ ("yield" ::: "memory");
+#else
+  __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
+
+/****************************************************************************/
+static void GetDeadline(struct timespec* pDeadline, uint32_t Wait)
+{
+  clock_gettime(CLOCK_MONOTONIC, pDeadline);
+  pDeadline->tv_sec += Wait / 1000;
+  pDeadline->tv_nsec += (long)(Wait % 1000) * 1000000L;
+
+  if(pDeadline->tv_nsec >= 1000000000L)
+  {
+    ++pDeadline->tv_sec;
+    pDeadline->tv_nsec -= 1000000000L;
+  }
+}
+
+/****************************************************************************/
+/* pDeadline is an absolute CLOCK_MONOTONIC time, NULL to wait forever.
+ * Returns false only when the deadline expired */
+static bool FutexWait(int32_t* pWord, int32_t iExpected, struct timespec const* pDeadline)
+{
+  if(syscall(SYS_futex, pWord, FUTEX_WAIT_BITSET_PRIVATE, iExpected, pDeadline, NULL, FUTEX_BITSET_MATCH_ANY) < 0)
+    return errno != ETIMEDOUT;
+  return true;
+}
+
+/****************************************************************************/
+static void FutexWake(int32_t* pWord, int iNumThreads)
+{
+  syscall(SYS_futex, pWord, FUTEX_WAKE_PRIVATE, iNumThreads, NULL, NULL, 0);
+}
+
+/****************************************************************************/
+/* takes one unit of a counter if it is positive */
+static bool TryDecrementPositive(int32_t* pCount)
+{
+  int32_t iCount = __atomic_load_n(pCount, __ATOMIC_RELAXED);
+
+  while(iCount > 0)
+  {
+    if(__atomic_compare_exchange_n(pCount, &iCount, iCount - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      return true;
+  }
+
+  return false;
+}
+
+/****************************************************************************/
+/* waits until TryDecrementPositive succeeds on pCount. pNumWaiters tells the
+ * releasing threads that someone might have to be woken up */
+static bool WaitDecrementPositive(int32_t* pCount, int32_t* pNumWaiters, uint32_t Wait)
+{
+  if(TryDecrementPositive(pCount))
+    return true;
+
+  if(Wait == AL_NO_WAIT)
+    return false;
+
+  for(int i = 0; i < MAX_SPIN; ++i)
+  {
+    CpuRelax();
+
+    if(TryDecrementPositive(pCount))
+      return true;
+  }
+
+  struct timespec Deadline;
+  struct timespec* pDeadline = NULL;
+
+  if(Wait != AL_WAIT_FOREVER)
+  {
+    GetDeadline(&Deadline, Wait);
+    pDeadline = &Deadline;
+  }
+
+  __atomic_add_fetch(pNumWaiters, 1, __ATOMIC_SEQ_CST);
+
+  bool bRet;
+
+  while(true)
+  {
+    if(TryDecrementPositive(pCount))
+    {
+      bRet = true;
+      break;
+    }
+
+    if(!FutexWait(pCount, 0, pDeadline))
+    {
+      bRet = TryDecrementPositive(pCount);
+      break;
+    }
+  }
+
+  __atomic_sub_fetch(pNumWaiters, 1, __ATOMIC_SEQ_CST);
+  return bRet;
+}
+
 /****************************************************************************/
 AL_64U Rtos_GetTime()
 {
@@ -304,14 +475,14 @@ void Rtos_Sleep(uint32_t uMillisecond)
 /****************************************************************************/
 AL_MUTEX Rtos_CreateMutex()
 {
-  pthread_mutex_t* pMutex = (AL_MUTEX)Rtos_Malloc(sizeof(pthread_mutex_t));
+  mtx_t* pMutex = (mtx_t*)Rtos_Malloc(sizeof(mtx_t));
 
   if(pMutex)
   {
-    pthread_mutexattr_t MutexAttr;
-    pthread_mutexattr_init(&MutexAttr);
-    pthread_mutexattr_settype(&MutexAttr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(pMutex, &MutexAttr);
+    pMutex->iState = MUTEX_FREE;
+    pMutex->uOwner = 0;
+    pMutex->iRecursion = 0;
+    pMutex->iSpin = MAX_SPIN / 2;
   }
   return (AL_MUTEX)pMutex;
 }
@@ -319,25 +490,71 @@ AL_MUTEX Rtos_CreateMutex()
 /****************************************************************************/
 void Rtos_DeleteMutex(AL_MUTEX Mutex)
 {
-  pthread_mutex_t* pMutex = (pthread_mutex_t*)Mutex;
+  mtx_t* pMutex = (mtx_t*)Mutex;
 
   if(pMutex)
   {
-    pthread_mutex_destroy(pMutex);
+    assert(pMutex->iState == MUTEX_FREE);
     Rtos_Free(pMutex);
   }
 }
 
+/****************************************************************************/
+static void LockMutex(mtx_t* pMutex)
+{
+  int32_t iState = MUTEX_FREE;
+
+  if(__atomic_compare_exchange_n(&pMutex->iState, &iState, MUTEX_LOCKED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return;
+
+  /* spin a bit if the owner usually releases the mutex quickly */
+  int32_t iLearnedSpin = __atomic_load_n(&pMutex->iSpin, __ATOMIC_RELAXED);
+  int iMaxSpin = iLearnedSpin * 2 + 10;
+
+  if(iMaxSpin > MAX_SPIN)
+    iMaxSpin = MAX_SPIN;
+
+  int iSpin = 0;
+
+  for(; iSpin < iMaxSpin; ++iSpin)
+  {
+    CpuRelax();
+    iState = MUTEX_FREE;
+
+    if(__atomic_load_n(&pMutex->iState, __ATOMIC_RELAXED) == MUTEX_FREE
+       && __atomic_compare_exchange_n(&pMutex->iState, &iState, MUTEX_LOCKED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      break;
+  }
+
+  __atomic_store_n(&pMutex->iSpin, iLearnedSpin + (iSpin - iLearnedSpin) / 8, __ATOMIC_RELAXED);
+
+  if(iSpin < iMaxSpin)
+    return;
+
+  while(__atomic_exchange_n(&pMutex->iState, MUTEX_CONTENDED, __ATOMIC_ACQUIRE) != MUTEX_FREE)
+    FutexWait(&pMutex->iState, MUTEX_CONTENDED, NULL);
+}
+
 /****************************************************************************/
 bool Rtos_GetMutex(AL_MUTEX Mutex)
 {
-  pthread_mutex_t* pMutex = (pthread_mutex_t*)Mutex;
+  mtx_t* pMutex = (mtx_t*)Mutex;
 
   if(!pMutex)
     return false;
 
-  if(pthread_mutex_lock(pMutex) < 0)
-    return false;
+  uintptr_t uSelf = GetThreadId();
+
+  /* only the owner itself can read its own id there */
+  if(__atomic_load_n(&pMutex->uOwner, __ATOMIC_RELAXED) == uSelf)
+  {
+    ++pMutex->iRecursion;
+    return true;
+  }
+
+  LockMutex(pMutex);
+  __atomic_store_n(&pMutex->uOwner, uSelf, __ATOMIC_RELAXED);
+  pMutex->iRecursion = 1;
 
   return true;
 }
@@ -345,22 +562,36 @@ bool Rtos_GetMutex(AL_MUTEX Mutex)
 /****************************************************************************/
 bool Rtos_ReleaseMutex(AL_MUTEX Mutex)
 {
-  if(!Mutex)
-    return false;
+  mtx_t* pMutex = (mtx_t*)Mutex;
 
-  if((pthread_mutex_unlock((pthread_mutex_t*)Mutex)) < 0)
+  if(!pMutex)
     return false;
 
+  /* releasing a mutex owned by another thread, or not locked at all */
+  assert(__atomic_load_n(&pMutex->uOwner, __ATOMIC_RELAXED) == GetThreadId());
+  assert(pMutex->iRecursion > 0);
+
+  if(--pMutex->iRecursion > 0)
+    return true;
+
+  __atomic_store_n(&pMutex->uOwner, 0, __ATOMIC_RELAXED);
+
+  if(__atomic_exchange_n(&pMutex->iState, MUTEX_FREE, __ATOMIC_RELEASE) == MUTEX_CONTENDED)
+    FutexWake(&pMutex->iState, 1);
+
   return true;
 }
 
 /****************************************************************************/
 AL_SEMAPHORE Rtos_CreateSemaphore(int iInitialCount)
 {
-  sem_t* pSem = (sem_t*)Rtos_Malloc(sizeof(sem_t));
+  sem_ctx_t* pSem = (sem_ctx_t*)Rtos_Malloc(sizeof(sem_ctx_t));
 
   if(pSem)
-    sem_init(pSem, 0, iInitialCount);
+  {
+    pSem->iCount = iInitialCount;
+    pSem->iNumWaiters = 0;
+  }
 
   return (AL_SEMAPHORE)pSem;
 }
@@ -368,72 +599,33 @@ AL_SEMAPHORE Rtos_CreateSemaphore(int iInitialCount)
 /****************************************************************************/
 void Rtos_DeleteSemaphore(AL_SEMAPHORE Semaphore)
 {
-  sem_t* pSem = (sem_t*)Semaphore;
-
-  if(pSem)
-  {
-    sem_destroy(pSem);
-    Rtos_Free(pSem);
-  }
+  Rtos_Free(Semaphore);
 }
 
 /****************************************************************************/
 bool Rtos_GetSemaphore(AL_SEMAPHORE Semaphore, uint32_t Wait)
 {
-  sem_t* pSem = (sem_t*)Semaphore;
+  sem_ctx_t* pSem = (sem_ctx_t*)Semaphore;
 
   if(!pSem)
     return false;
 
-  int ret;
-
-  if(Wait == AL_NO_WAIT)
-  {
-    do
-    {
-      ret = sem_trywait(pSem);
-    }
-    while(ret == -1 && errno == EINTR);
-
-    return ret == 0;
-  }
-  else if(Wait == AL_WAIT_FOREVER)
-  {
-    do
-    {
-      ret = sem_wait(pSem);
-    }
-    while(ret == -1 && errno == EINTR);
-
-    return ret == 0;
-  }
-  else
-  {
-    struct timespec Ts;
-    Ts.tv_sec = Wait / 1000;
-    Ts.tv_nsec = (Wait % 1000) * 1000000;
-
-    do
-    {
-      ret = sem_timedwait(pSem, &Ts);
-    }
-    while(ret == -1 && errno == EINTR);
-
-    return ret == 0;
-  }
-
-  return true;
+  return WaitDecrementPositive(&pSem->iCount, &pSem->iNumWaiters, Wait);
 }
 
 /****************************************************************************/
 bool Rtos_ReleaseSemaphore(AL_SEMAPHORE Semaphore)
 {
-  sem_t* pSem = (sem_t*)Semaphore;
+  sem_ctx_t* pSem = (sem_ctx_t*)Semaphore;
 
   if(!pSem)
     return false;
 
-  sem_post(pSem);
+  __atomic_add_fetch(&pSem->iCount, 1, __ATOMIC_SEQ_CST);
+
+  if(__atomic_load_n(&pSem->iNumWaiters, __ATOMIC_SEQ_CST))
+    FutexWake(&pSem->iCount, 1);
+
   return true;
 }
 
@@ -444,9 +636,8 @@ AL_EVENT Rtos_CreateEvent(bool bInitialState)
 
   if(pEvt)
   {
-    pthread_mutex_init(&pEvt->Mutex, 0);
-    pthread_cond_init(&pEvt->Cond, 0);
-    pEvt->bSignaled = bInitialState;
+    pEvt->iSignaled = bInitialState ? 1 : 0;
+    pEvt->iNumWaiters = 0;
   }
   return (AL_EVENT)pEvt;
 }
@@ -454,14 +645,7 @@ AL_EVENT Rtos_CreateEvent(bool bInitialState)
 /****************************************************************************/
 void Rtos_DeleteEvent(AL_EVENT Event)
 {
-  evt_t* pEvt = (evt_t*)Event;
-
-  if(pEvt)
-  {
-    pthread_cond_destroy(&pEvt->Cond);
-    pthread_mutex_destroy(&pEvt->Mutex);
-  }
-  Rtos_Free(pEvt);
+  Rtos_Free(Event);
 }
 
 /****************************************************************************/
@@ -472,58 +656,137 @@ bool Rtos_WaitEvent(AL_EVENT Event, uint32_t Wait)
   if(!pEvt)
     return false;
 
-  bool bRet = true;
+  /* the event resets itself when a waiter goes through: it is a binary semaphore */
+  return WaitDecrementPositive(&pEvt->iSignaled, &pEvt->iNumWaiters, Wait);
+}
 
-  pthread_mutex_lock(&pEvt->Mutex);
+/****************************************************************************/
+bool Rtos_SetEvent(AL_EVENT Event)
+{
+  evt_t* pEvt = (evt_t*)Event;
 
-  if(Wait == AL_WAIT_FOREVER)
+  __atomic_store_n(&pEvt->iSignaled, 1, __ATOMIC_SEQ_CST);
+
+  if(__atomic_load_n(&pEvt->iNumWaiters, __ATOMIC_SEQ_CST))
+    FutexWake(&pEvt->iSignaled, 1);
+
+  return true;
+}
+
+/****************************************************************************/
+static pthread_t GetNative(AL_THREAD Thread)
+{
+  return *((pthread_t*)Thread);
+}
+
+/****************************************************************************/
+AL_THREAD Rtos_CreateThread(void* (*pFunc)(void* pParam), void* pParam)
+{
+  return Rtos_CreateThreadWithAttr(pFunc, pParam, NULL);
+}
+
+/****************************************************************************/
+static void SetThreadAttr(pthread_attr_t* pThreadAttr, AL_TThreadAttr const* pAttr)
+{
+  if(pAttr->zStackSize)
   {
-    while(bRet && !pEvt->bSignaled)
-      bRet = (pthread_cond_wait(&pEvt->Cond, &pEvt->Mutex) == 0);
+    size_t zStackSize = pAttr->zStackSize < (size_t)PTHREAD_STACK_MIN ? (size_t)PTHREAD_STACK_MIN : pAttr->zStackSize;
+    pthread_attr_setstacksize(pThreadAttr, zStackSize);
   }
-  else
+
+  if(pAttr->uAffinityMask)
   {
-    struct timeval now;
-    gettimeofday(&now, NULL);
+    cpu_set_t CpuSet;
+    CPU_ZERO(&CpuSet);
 
-    struct timespec deadline;
-    deadline.tv_sec = now.tv_sec + Wait / 1000;
-    deadline.tv_nsec = (now.tv_usec + 1000UL * (Wait % 1000)) * 1000UL;
+    for(int iCpu = 0; iCpu < 64; ++iCpu)
+    {
+      if(pAttr->uAffinityMask & ((uint64_t)1 << iCpu))
+        CPU_SET(iCpu, &CpuSet);
+    }
 
-    while(bRet && !pEvt->bSignaled)
-      bRet = (pthread_cond_timedwait(&pEvt->Cond, &pEvt->Mutex, &deadline) == 0);
+    pthread_attr_setaffinity_np(pThreadAttr, sizeof(CpuSet), &CpuSet);
   }
 
-  if(bRet)
-    pEvt->bSignaled = false;
-  pthread_mutex_unlock(&pEvt->Mutex);
-  return bRet;
+  if(pAttr->iPriority)
+  {
+    struct sched_param Param = { 0 };
+    Param.sched_priority = pAttr->iPriority;
+    pthread_attr_setinheritsched(pThreadAttr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(pThreadAttr, SCHED_FIFO);
+    pthread_attr_setschedparam(pThreadAttr, &Param);
+  }
 }
 
-/****************************************************************************/
-bool Rtos_SetEvent(AL_EVENT Event)
+typedef struct
 {
-  evt_t* pEvt = (evt_t*)Event;
-  pthread_mutex_lock(&pEvt->Mutex);
-  pEvt->bSignaled = true;
-  bool bRet = pthread_cond_signal(&pEvt->Cond) == 0;
-  pthread_mutex_unlock(&pEvt->Mutex);
-  return bRet;
-}
+  void* (*pFunc)(void* pParam);
+  void* pParam;
+  char name[16];
+}NamedThreadStart;
 
 /****************************************************************************/
-static pthread_t GetNative(AL_THREAD Thread)
+/* the name is set by the thread itself, so that it is already there when pFunc starts */
+static void* NamedThreadEntry(void* p)
 {
-  return *((pthread_t*)Thread);
+  NamedThreadStart Start = *(NamedThreadStart*)p;
+  Rtos_Free(p);
+  pthread_setname_np(pthread_self(), Start.name);
+  return Start.pFunc(Start.pParam);
 }
 
 /****************************************************************************/
-AL_THREAD Rtos_CreateThread(void* (*pFunc)(void* pParam), void* pParam)
+AL_THREAD Rtos_CreateThreadWithAttr(void* (*pFunc)(void* pParam), void* pParam, AL_TThreadAttr const* pAttr)
 {
   pthread_t* thread = Rtos_Malloc(sizeof(pthread_t));
 
-  if(thread)
-    pthread_create(thread, NULL, pFunc, pParam);
+  if(!thread)
+    return NULL;
+
+  if(pAttr && pAttr->pName)
+  {
+    NamedThreadStart* pStart = Rtos_Malloc(sizeof(*pStart));
+
+    if(!pStart)
+    {
+      Rtos_Free(thread);
+      return NULL;
+    }
+
+    pStart->pFunc = pFunc;
+    pStart->pParam = pParam;
+    strncpy(pStart->name, pAttr->pName, sizeof(pStart->name) - 1);
+    pStart->name[sizeof(pStart->name) - 1] = '\0';
+
+    pFunc = &NamedThreadEntry;
+    pParam = pStart;
+  }
+
+  pthread_attr_t ThreadAttr;
+  pthread_attr_init(&ThreadAttr);
+
+  if(pAttr)
+    SetThreadAttr(&ThreadAttr, pAttr);
+
+  int iRet = pthread_create(thread, &ThreadAttr, pFunc, pParam);
+
+  if(iRet == EPERM && pAttr && pAttr->iPriority)
+  {
+    /* real-time scheduling needs privileges, keep the other attributes */
+    pthread_attr_setinheritsched(&ThreadAttr, PTHREAD_INHERIT_SCHED);
+    iRet = pthread_create(thread, &ThreadAttr, pFunc, pParam);
+  }
+
+  pthread_attr_destroy(&ThreadAttr);
+
+  if(iRet != 0)
+  {
+    if(pFunc == &NamedThreadEntry)
+      Rtos_Free(pParam);
+    Rtos_Free(thread);
+    return NULL;
+  }
+
   return (AL_THREAD)thread;
 }
 
@@ -0,0 +1,269 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Runs an MCU decoder channel on top of a fake driver, with a status thread,
+ * with an event reactor and with a driver that can't be polled (the channel
+ * falls back to a status thread). The channel is destroyed while statuses are
+ * still queued: they must all be reported, in order, before the destruction
+ * returns. In reactor mode, the status is never asked before it's ready. */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "lib_decode/I_DecChannel.h"
+#include "lib_decode/DecChannelMcu.h"
+#include "lib_common/IDriver.h"
+#include "lib_common/Error.h"
+#include "lib_common/EventReactor.h"
+#include "lib_rtos/lib_rtos.h"
+#include "allegro_ioctl_mcu_dec.h"
+#include "test/Check.h"
+
+#define NUM_STATUS 20000
+#define NUM_QUEUED_ON_DESTROY 100
+#define PAUSE_PERIOD 1000
+
+/* one channel at a time. The statuses are counted by a semaphore, mirrored
+ * in an eventfd so that the reactor can poll them */
+typedef struct
+{
+  AL_TDriver base;
+  bool bPollable;
+  bool bMustNotBlock;
+  int fd;
+  AL_MUTEX hMutex;
+  AL_SEMAPHORE hReady;
+  AL_EVENT hDestroyed;
+  int iNumPending;
+  int iNumSent;
+  bool bDestroyed;
+  int iNumWouldBlock;
+}TFakeDriver;
+
+typedef struct
+{
+  int iNumReceived;
+  int iBlockAt;
+  AL_EVENT hDestroyed;
+}TReceiver;
+
+/*****************************************************************************/
+static void Signal(TFakeDriver* pDrv)
+{
+  uint64_t uOne = 1;
+  Rtos_ReleaseSemaphore(pDrv->hReady);
+
+  if(pDrv->bPollable)
+    CHECK(write(pDrv->fd, &uOne, sizeof(uOne)) == sizeof(uOne));
+}
+
+/*****************************************************************************/
+static int FakeOpen(AL_TDriver* driver, const char* device)
+{
+  TFakeDriver* pDrv = (TFakeDriver*)driver;
+  (void)device;
+
+  /* the channel fd. /dev/null has no poll() support */
+  pDrv->fd = pDrv->bPollable ? eventfd(0, EFD_SEMAPHORE) : open("/dev/null", O_RDONLY);
+  return pDrv->fd;
+}
+
+/*****************************************************************************/
+static void FakeClose(AL_TDriver* driver, int fd)
+{
+  (void)driver;
+  close(fd);
+}
+
+/*****************************************************************************/
+static AL_EDriverError WaitForStatus(TFakeDriver* pDrv, struct al5_params* pMsg)
+{
+  if(!Rtos_GetSemaphore(pDrv->hReady, AL_NO_WAIT))
+  {
+    if(pDrv->bMustNotBlock)
+    {
+      Rtos_GetMutex(pDrv->hMutex);
+      ++pDrv->iNumWouldBlock;
+      Rtos_ReleaseMutex(pDrv->hMutex);
+      return DRIVER_ERROR_UNKNOWN;
+    }
+    Rtos_GetSemaphore(pDrv->hReady, AL_WAIT_FOREVER);
+  }
+
+  Rtos_GetMutex(pDrv->hMutex);
+
+  if(!pDrv->iNumPending)
+  {
+    /* the channel ended: every following wait fails without blocking */
+    CHECK(pDrv->bDestroyed);
+    Rtos_ReleaseSemaphore(pDrv->hReady);
+    Rtos_ReleaseMutex(pDrv->hMutex);
+    return DRIVER_ERROR_CHANNEL;
+  }
+
+  uint64_t uCount;
+
+  if(pDrv->bPollable)
+    CHECK(read(pDrv->fd, &uCount, sizeof(uCount)) == sizeof(uCount));
+
+  AL_TDecPicStatus status = { 0 };
+  status.uNumLCU = pDrv->iNumSent++;
+  --pDrv->iNumPending;
+  Rtos_ReleaseMutex(pDrv->hMutex);
+
+  pMsg->size = sizeof(status);
+  Rtos_Memcpy(pMsg->opaque, &status, sizeof(status));
+  return DRIVER_SUCCESS;
+}
+
+/*****************************************************************************/
+static AL_EDriverError FakePostMessage(AL_TDriver* driver, int fd, long unsigned int messageId, void* data)
+{
+  TFakeDriver* pDrv = (TFakeDriver*)driver;
+  CHECK(fd == pDrv->fd);
+
+  switch(messageId)
+  {
+  case AL_MCU_CONFIG_CHANNEL:
+    return DRIVER_SUCCESS;
+
+  case AL_MCU_WAIT_FOR_STATUS:
+    return WaitForStatus(pDrv, (struct al5_params*)data);
+
+  case AL_MCU_DESTROY_CHANNEL:
+    Rtos_GetMutex(pDrv->hMutex);
+    pDrv->bDestroyed = true;
+    Signal(pDrv);
+    Rtos_ReleaseMutex(pDrv->hMutex);
+    Rtos_SetEvent(pDrv->hDestroyed);
+    return DRIVER_SUCCESS;
+
+  default:
+    return DRIVER_ERROR_UNKNOWN;
+  }
+}
+
+static const AL_DriverVtable FakeDriverVtable =
+{
+  &FakeOpen,
+  &FakeClose,
+  &FakePostMessage,
+};
+
+/*****************************************************************************/
+static void PushStatus(TFakeDriver* pDrv)
+{
+  Rtos_GetMutex(pDrv->hMutex);
+  ++pDrv->iNumPending;
+  Signal(pDrv);
+  Rtos_ReleaseMutex(pDrv->hMutex);
+}
+
+/*****************************************************************************/
+static void OnEndFrameDecoding(void* pUserParam, AL_TDecPicStatus* pStatus)
+{
+  TReceiver* pReceiver = (TReceiver*)pUserParam;
+  CHECK((int)pStatus->uNumLCU == pReceiver->iNumReceived);
+  ++pReceiver->iNumReceived;
+
+  /* keep the last statuses queued until the destruction is requested */
+  if(pReceiver->iNumReceived == pReceiver->iBlockAt)
+    Rtos_WaitEvent(pReceiver->hDestroyed, AL_WAIT_FOREVER);
+}
+
+/*****************************************************************************/
+static void RunChannel(bool bUseReactor, bool bPollable)
+{
+  TFakeDriver drv = { 0 };
+  drv.base.vtable = &FakeDriverVtable;
+  drv.bPollable = bPollable;
+  drv.bMustNotBlock = bUseReactor && bPollable;
+  drv.fd = -1;
+  drv.hMutex = Rtos_CreateMutex();
+  drv.hReady = Rtos_CreateSemaphore(0);
+  drv.hDestroyed = Rtos_CreateEvent(false);
+  CHECK(drv.hMutex && drv.hReady && drv.hDestroyed);
+
+  AL_TEventReactor* pReactor = NULL;
+
+  if(bUseReactor)
+  {
+    pReactor = AL_EventReactor_Create(1);
+    CHECK(pReactor);
+  }
+
+  TReceiver receiver = { 0 };
+  receiver.iBlockAt = NUM_STATUS - NUM_QUEUED_ON_DESTROY + 1;
+  receiver.hDestroyed = drv.hDestroyed;
+
+  AL_TIDecChannel* pChannel = AL_DecChannelMcu_CreateWithReactor(&drv.base, pReactor);
+  CHECK(pChannel);
+
+  AL_TDecChanParam chanParam = { 0 };
+  AL_CB_EndFrameDecoding callback = { &OnEndFrameDecoding, &receiver };
+  CHECK(AL_IDecChannel_Configure(pChannel, &chanParam, callback, NULL) == AL_SUCCESS);
+
+  for(int i = 0; i < NUM_STATUS; ++i)
+  {
+    PushStatus(&drv);
+
+    if(i % PAUSE_PERIOD == 0)
+      Rtos_Sleep(1);
+  }
+
+  AL_IDecChannel_Destroy(pChannel);
+
+  CHECK(receiver.iNumReceived == NUM_STATUS);
+  CHECK(drv.iNumWouldBlock == 0);
+
+  AL_EventReactor_Destroy(pReactor);
+  Rtos_DeleteEvent(drv.hDestroyed);
+  Rtos_DeleteSemaphore(drv.hReady);
+  Rtos_DeleteMutex(drv.hMutex);
+}
+
+/*****************************************************************************/
+int main(void)
+{
+  RunChannel(false, true);
+  RunChannel(true, true);
+  RunChannel(true, false);
+
+  printf("DecChannelMcuTest: %d statuses with thread, reactor and fallback OK\n", NUM_STATUS);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Differential test of the DPB node indexes: every indexed lookup must return
+ * the node found by walking the POC, poc_lsb and decoding order lists. */
+
+#include "lib_parsing/DPB.c"
+#include "test/Check.h"
+
+#define NUM_STEPS 200000
+
+/* key ranges small enough that nodes share keys, large enough to build probe clusters */
+#define NUM_POC 65
+#define NUM_POC_LSB 17
+#define NUM_FRM_ID 40
+
+/*****************************************************************************/
+static void NoFrmCb(void* pUserParam, int iFrameID)
+{
+  (void)pUserParam;
+  (void)iFrameID;
+}
+
+static void NoMvCb(void* pUserParam, uint8_t uMvID)
+{
+  (void)pUserParam;
+  (void)uMvID;
+}
+
+/*****************************************************************************/
+static uint8_t GetNodeFromFrmIDInList(AL_TDpb* pDpb, int iFrameID)
+{
+  for(uint8_t uNode = pDpb->uHeadDecOrder; uNode != uEndOfList; uNode = pDpb->Nodes[uNode].uNextDecOrder)
+  {
+    if(pDpb->Nodes[uNode].uFrmID == iFrameID)
+      return uNode;
+  }
+
+  return uEndOfList;
+}
+
+/*****************************************************************************/
+static int CountIndexed(AL_TDpbIndex const* pIndex)
+{
+  int iCount = 0;
+
+  for(int i = 0; i < DPB_INDEX_SIZE; ++i)
+    iCount += pIndex->pNodes[i] != uEndOfList;
+
+  return iCount;
+}
+
+/*****************************************************************************/
+static void CheckIndexes(AL_TDpb* pDpb, int iNumNodes)
+{
+  CHECK(CountIndexed(&pDpb->PocIndex) == iNumNodes);
+  CHECK(CountIndexed(&pDpb->PocLsbIndex) == iNumNodes);
+  CHECK(CountIndexed(&pDpb->FrmIDIndex) == iNumNodes);
+
+  /* POC 0 is the key used by the reindex of AL_Dpb_sSetAllPicAsUnused */
+  for(int iPOC = -NUM_POC / 2; iPOC <= NUM_POC / 2; ++iPOC)
+    CHECK(AL_Dpb_SearchPOC(pDpb, iPOC) == AL_Dpb_sSearchPOCInList(pDpb, iPOC));
+
+  for(uint32_t uPocLsb = 0; uPocLsb < NUM_POC_LSB; ++uPocLsb)
+    CHECK(AL_Dpb_SearchPocLsb(pDpb, uPocLsb) == AL_Dpb_sSearchPocLsbInList(pDpb, uPocLsb));
+
+  for(int iFrmID = 0; iFrmID < NUM_FRM_ID; ++iFrmID)
+    CHECK(Dpb_GetNodeFromFrmID(pDpb, iFrmID) == GetNodeFromFrmIDInList(pDpb, iFrmID));
+}
+
+/*****************************************************************************/
+static uint8_t PickNode(bool const* pUsed, uint32_t* pSeed, bool bUsed)
+{
+  uint8_t uNode = Test_Rand(pSeed) % MAX_DPB_SIZE;
+
+  while(pUsed[uNode] != bUsed)
+    uNode = (uNode + 1) % MAX_DPB_SIZE;
+
+  return uNode;
+}
+
+/*****************************************************************************/
+int main(int argc, char** argv)
+{
+  uint32_t uSeed = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 0x2545F491;
+  AL_TDpbCallback tCallbacks = { NoFrmCb, NoFrmCb, NoFrmCb, NoMvCb, NoMvCb, NULL };
+  AL_TAvcSliceHdr tSlice = { 0 };
+  static AL_TDpb tDpb;
+  bool bUsed[MAX_DPB_SIZE] = { false };
+  int iNumNodes = 0;
+  int iNumPics = 0;
+
+  CHECK(uSeed != 0);
+  AL_Dpb_Init(&tDpb, MAX_REF, AL_DPB_NORMAL, tCallbacks);
+
+  for(int iStep = 0; iStep < NUM_STEPS; ++iStep)
+  {
+    uint32_t uOp = Test_Rand(&uSeed) % 16;
+
+    if(uOp < 7 && iNumNodes < MAX_DPB_SIZE)
+    {
+      uint8_t uNode = PickNode(bUsed, &uSeed, false);
+      int iPOC = (int)(Test_Rand(&uSeed) % NUM_POC) - NUM_POC / 2;
+      uint32_t uPocLsb = Test_Rand(&uSeed) % NUM_POC_LSB;
+      uint8_t uFrmID = Test_Rand(&uSeed) % NUM_FRM_ID;
+      /* a real picture needs a pic ID, the pool is smaller than the DPB */
+      uint8_t uNonExisting = iNumPics >= PIC_ID_POOL_SIZE || Test_Rand(&uSeed) % 4 == 0;
+      AL_EMarkingRef eMarking = (AL_EMarkingRef)(Test_Rand(&uSeed) % 3);
+
+      AL_Dpb_Insert(&tDpb, iPOC, uPocLsb, uNode, uFrmID, uNode, 0, eMarking, uNonExisting, AL_HEVC_NUT_ERR);
+      bUsed[uNode] = true;
+      ++iNumNodes;
+      iNumPics += !uNonExisting;
+    }
+    else if(uOp < 11 && iNumNodes)
+    {
+      uint8_t uNode = PickNode(bUsed, &uSeed, true);
+      iNumPics -= !tDpb.Nodes[uNode].non_existing;
+      AL_Dpb_Remove(&tDpb, uNode);
+      bUsed[uNode] = false;
+      --iNumNodes;
+    }
+    else if(uOp < 14 && iNumNodes)
+    {
+      uint8_t uNode = PickNode(bUsed, &uSeed, true);
+      AL_Dpb_SetMarkingFlag(&tDpb, uNode, (AL_EMarkingRef)(Test_Rand(&uSeed) % 3));
+    }
+    else if(uOp == 14 && iNumNodes)
+    {
+      /* MMCO 5: everything but the current picture goes, which is reindexed with POC 0 */
+      uint8_t uCurRef = tDpb.uCurRef;
+
+      if(!bUsed[uCurRef])
+        continue;
+
+      AL_Dpb_sSetAllPicAsUnused(&tDpb, &tSlice);
+      CHECK(tDpb.Nodes[uCurRef].iFramePOC == 0);
+
+      for(int i = 0; i < MAX_DPB_SIZE; ++i)
+        bUsed[i] = i == uCurRef;
+
+      iNumNodes = 1;
+      iNumPics = !tDpb.Nodes[uCurRef].non_existing;
+    }
+    else if(uOp == 15 && Test_Rand(&uSeed) % 8 == 0)
+    {
+      AL_Dpb_Flush(&tDpb);
+
+      for(int i = 0; i < MAX_DPB_SIZE; ++i)
+        bUsed[i] = false;
+
+      iNumNodes = 0;
+      iNumPics = 0;
+    }
+
+    AL_Dpb_sReleaseUnusedBuf(&tDpb, true);
+    CHECK(tDpb.uCountPic == iNumNodes);
+    CheckIndexes(&tDpb, iNumNodes);
+  }
+
+  AL_Dpb_Flush(&tDpb);
+  CheckIndexes(&tDpb, 0);
+  AL_Dpb_Terminate(&tDpb);
+  AL_Dpb_Deinit(&tDpb);
+
+  printf("DpbIndexTest: %d steps OK\n", NUM_STEPS);
+  return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,135 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Stress test of the decoder event queue: several producers push concurrently
+ * while the consumer pops. Producers pause from time to time so that the
+ * consumer also goes through the futex sleep / wake up path. */
+
+#include "lib_decode/EventQueue.h"
+#include "lib_common/List.h"
+#include "lib_rtos/lib_rtos.h"
+#include "test/Check.h"
+
+#define NUM_PRODUCERS 6
+#define NUM_MSGS 200000
+#define PAUSE_PERIOD 1000
+
+typedef struct
+{
+  AL_QueueNode Node;
+  int iProducer;
+  int iSeq;
+}TMsg;
+
+typedef struct
+{
+  AL_EventQueue* pQueue;
+  int iProducer;
+  TMsg* pMsgs;
+}TProducer;
+
+/*****************************************************************************/
+static void* Produce(void* pParam)
+{
+  TProducer* pProducer = (TProducer*)pParam;
+
+  for(int i = 0; i < NUM_MSGS; ++i)
+  {
+    TMsg* pMsg = &pProducer->pMsgs[i];
+    pMsg->iProducer = pProducer->iProducer;
+    pMsg->iSeq = i;
+    AL_EventQueue_Push(pProducer->pQueue, &pMsg->Node);
+
+    if(i % PAUSE_PERIOD == 0)
+      Rtos_Sleep(1);
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+int main(void)
+{
+  static AL_EventQueue tQueue;
+  TProducer producers[NUM_PRODUCERS];
+  AL_THREAD threads[NUM_PRODUCERS];
+  int iLastSeq[NUM_PRODUCERS];
+
+  AL_EventQueue_Init(&tQueue);
+  CHECK(AL_EventQueue_TryPop(&tQueue) == NULL);
+
+  for(int i = 0; i < NUM_PRODUCERS; ++i)
+  {
+    producers[i].pQueue = &tQueue;
+    producers[i].iProducer = i;
+    producers[i].pMsgs = (TMsg*)Rtos_Malloc(NUM_MSGS * sizeof(TMsg));
+    CHECK(producers[i].pMsgs);
+    iLastSeq[i] = -1;
+  }
+
+  for(int i = 0; i < NUM_PRODUCERS; ++i)
+  {
+    threads[i] = Rtos_CreateThread(Produce, &producers[i]);
+    CHECK(threads[i]);
+  }
+
+  /* every message comes out exactly once, in push order for each producer */
+  for(long i = 0; i < (long)NUM_PRODUCERS * NUM_MSGS; ++i)
+  {
+    TMsg* pMsg = containerOf(AL_EventQueue_Fetch(&tQueue), TMsg, Node);
+    CHECK(pMsg->iProducer >= 0 && pMsg->iProducer < NUM_PRODUCERS);
+    CHECK(pMsg->iSeq == iLastSeq[pMsg->iProducer] + 1);
+    iLastSeq[pMsg->iProducer] = pMsg->iSeq;
+  }
+
+  for(int i = 0; i < NUM_PRODUCERS; ++i)
+  {
+    CHECK(Rtos_JoinThread(threads[i]));
+    Rtos_DeleteThread(threads[i]);
+    CHECK(iLastSeq[i] == NUM_MSGS - 1);
+  }
+
+  CHECK(AL_EventQueue_TryPop(&tQueue) == NULL);
+  AL_EventQueue_Deinit(&tQueue);
+
+  for(int i = 0; i < NUM_PRODUCERS; ++i)
+    Rtos_Free(producers[i].pMsgs);
+
+  printf("EventQueueTest: %d producers x %d messages OK\n", NUM_PRODUCERS, NUM_MSGS);
+  return EXIT_SUCCESS;
+}
+
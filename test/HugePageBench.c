@@ -0,0 +1,127 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Compares frame copies between buffers of the default allocator and of the
+ * hugepage allocator. Copying 64x64 tiles touches a new row, so a new 4KB page,
+ * for every 64 bytes: that is where the dTLB misses show. */
+
+#include <string.h>
+#include <time.h>
+#include "lib_common/Allocator.h"
+#include "test/Check.h"
+
+#define WIDTH 7680
+#define HEIGHT 4320
+#define TILE 64
+#define NUM_RUNS 10
+
+/*****************************************************************************/
+static double GetTime(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/*****************************************************************************/
+static void CopyTiled(uint8_t* pDst, uint8_t const* pSrc)
+{
+  for(int iTileY = 0; iTileY < HEIGHT; iTileY += TILE)
+  {
+    for(int iTileX = 0; iTileX < WIDTH; iTileX += TILE)
+    {
+      for(int y = iTileY; y < iTileY + TILE; ++y)
+        memcpy(pDst + (size_t)y * WIDTH + iTileX, pSrc + (size_t)y * WIDTH + iTileX, TILE);
+    }
+  }
+}
+
+/*****************************************************************************/
+static void CopyRows(uint8_t* pDst, uint8_t const* pSrc, int iNumRows)
+{
+  for(int y = 0; y < iNumRows; ++y)
+    memcpy(pDst + (size_t)y * WIDTH, pSrc + (size_t)y * WIDTH, WIDTH);
+}
+
+/*****************************************************************************/
+static void Bench(AL_TAllocator* pAllocator, char const* sName)
+{
+  size_t zSize = (size_t)WIDTH * HEIGHT * 3 / 2; // NV12
+  AL_HANDLE hSrc = AL_Allocator_Alloc(pAllocator, zSize);
+  AL_HANDLE hDst = AL_Allocator_Alloc(pAllocator, zSize);
+  CHECK(hSrc && hDst);
+
+  uint8_t* pSrc = AL_Allocator_GetVirtualAddr(pAllocator, hSrc);
+  uint8_t* pDst = AL_Allocator_GetVirtualAddr(pAllocator, hDst);
+
+  // fault the pages in before timing
+  memset(pSrc, 0x80, zSize);
+  memset(pDst, 0, zSize);
+
+  double fBestTiled = 1e9;
+  double fBestRows = 1e9;
+
+  for(int iRun = 0; iRun < NUM_RUNS; ++iRun)
+  {
+    double fStart = GetTime();
+    CopyTiled(pDst, pSrc); // luma
+    CopyRows(pDst + (size_t)WIDTH * HEIGHT, pSrc + (size_t)WIDTH * HEIGHT, HEIGHT / 2); // chroma
+    double fTiled = GetTime() - fStart;
+
+    fStart = GetTime();
+    CopyRows(pDst, pSrc, HEIGHT * 3 / 2);
+    double fRows = GetTime() - fStart;
+
+    fBestTiled = fTiled < fBestTiled ? fTiled : fBestTiled;
+    fBestRows = fRows < fBestRows ? fRows : fBestRows;
+  }
+
+  CHECK(memcmp(pSrc, pDst, zSize) == 0);
+  printf("%-10s tiled copy %7.2f ms, row copy %7.2f ms\n", sName, fBestTiled * 1e3, fBestRows * 1e3);
+
+  AL_Allocator_Free(pAllocator, hSrc);
+  AL_Allocator_Free(pAllocator, hDst);
+}
+
+/*****************************************************************************/
+int main(void)
+{
+  Bench(AL_GetDefaultAllocator(), "default");
+  Bench(AL_GetHugePageAllocator(), "hugepage");
+  return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,104 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Admission of channels on the encoder resource ledger: a 4K60 stream takes
+ * the whole budget of the device and a 1080p60 stream next to it is refused. */
+
+#include "lib_common/ResourceLedger.h"
+#include "test/Check.h"
+
+/*****************************************************************************/
+static int CountBits(uint32_t uMask)
+{
+  int iCount = 0;
+
+  for(; uMask; uMask &= uMask - 1)
+    ++iCount;
+
+  return iCount;
+}
+
+/*****************************************************************************/
+static void CheckBooked(AL_TResourceLedger* pLedger, int iFreeBefore, AL_TAdmission const* pAdmission)
+{
+  /* the load is split evenly over the channel cores, rounded up on each */
+  int iBooked = iFreeBefore - AL_ResourceLedger_GetHeadroom(pLedger);
+  CHECK(iBooked >= pAdmission->resources && iBooked < pAdmission->resources + pAdmission->numCores);
+  CHECK(CountBits(pAdmission->coreMask) == pAdmission->numCores);
+}
+
+/*****************************************************************************/
+int main(void)
+{
+  AL_TResourceLedger* pLedger = AL_GetEncoderResourceLedger();
+  CHECK(pLedger);
+  CHECK(AL_GetEncoderResourceLedger() == pLedger);
+
+  int iFull = AL_ResourceLedger_GetHeadroom(pLedger);
+  CHECK(iFull > 0);
+
+  /* querying doesn't book anything */
+  AL_TAdmission t4K;
+  CHECK(AL_ResourceLedger_Query(pLedger, 3840, 2160, 60000, 1000, 0, &t4K));
+  CHECK(AL_ResourceLedger_GetHeadroom(pLedger) == iFull);
+
+  CHECK(AL_ResourceLedger_Admit(pLedger, 3840, 2160, 60000, 1000, 0, &t4K));
+  CHECK(t4K.headroom >= 0 && t4K.headroom == iFull - t4K.resources);
+  CheckBooked(pLedger, iFull, &t4K);
+  printf("4K60: %d cores, %d blocks/s, headroom %d\n", t4K.numCores, t4K.resources, t4K.headroom);
+
+  /* the 1080p60 stream doesn't fit next to it: refused, nothing booked */
+  int iFree = AL_ResourceLedger_GetHeadroom(pLedger);
+  AL_TAdmission t1080p;
+  CHECK(!AL_ResourceLedger_Admit(pLedger, 1920, 1080, 60000, 1000, 0, &t1080p));
+  CHECK(t1080p.headroom < 0 && t1080p.headroom == iFree - t1080p.resources);
+  CHECK(AL_ResourceLedger_GetHeadroom(pLedger) == iFree);
+  printf("1080p60: refused, missing %d blocks/s\n", -t1080p.headroom);
+
+  /* once the 4K60 stream is gone, the 1080p60 stream is admitted */
+  AL_ResourceLedger_Release(pLedger, &t4K);
+  CHECK(AL_ResourceLedger_GetHeadroom(pLedger) == iFull);
+
+  CHECK(AL_ResourceLedger_Admit(pLedger, 1920, 1080, 60000, 1000, 0, &t1080p));
+  CheckBooked(pLedger, iFull, &t1080p);
+  AL_ResourceLedger_Release(pLedger, &t1080p);
+  CHECK(AL_ResourceLedger_GetHeadroom(pLedger) == iFull);
+
+  printf("ResourceLedgerTest: OK\n");
+  return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,193 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Micro-benchmarks of the rtos synchronization primitives, in ns per operation */
+
+#include <time.h>
+#include "lib_rtos/lib_rtos.h"
+#include "test/Check.h"
+
+#define NUM_THREADS 4
+#define NUM_ITERATIONS 1000000
+
+static AL_MUTEX s_Mutex;
+static long s_iCounter;
+static AL_SEMAPHORE s_Sem;
+static AL_EVENT s_Ping;
+static AL_EVENT s_Pong;
+
+/*****************************************************************************/
+static double GetTime(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/*****************************************************************************/
+static void Report(char const* sName, double fStart, long iNumOps)
+{
+  printf("%-28s %6.1f ns/op\n", sName, (GetTime() - fStart) / iNumOps * 1e9);
+}
+
+/*****************************************************************************/
+static void* Lock(void* pParam)
+{
+  (void)pParam;
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+  {
+    Rtos_GetMutex(s_Mutex);
+    ++s_iCounter;
+    Rtos_ReleaseMutex(s_Mutex);
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+static void* Consume(void* pParam)
+{
+  (void)pParam;
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+    Rtos_GetSemaphore(s_Sem, AL_WAIT_FOREVER);
+
+  return NULL;
+}
+
+/*****************************************************************************/
+static void* Pong(void* pParam)
+{
+  int iNumRounds = *(int*)pParam;
+
+  for(int i = 0; i < iNumRounds; ++i)
+  {
+    Rtos_WaitEvent(s_Ping, AL_WAIT_FOREVER);
+    Rtos_SetEvent(s_Pong);
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+int main(void)
+{
+  AL_THREAD threads[NUM_THREADS];
+
+  s_Mutex = Rtos_CreateMutex();
+  s_Sem = Rtos_CreateSemaphore(0);
+  s_Ping = Rtos_CreateEvent(false);
+  s_Pong = Rtos_CreateEvent(false);
+  CHECK(s_Mutex && s_Sem && s_Ping && s_Pong);
+
+  double fStart = GetTime();
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+  {
+    Rtos_GetMutex(s_Mutex);
+    Rtos_ReleaseMutex(s_Mutex);
+  }
+
+  Report("mutex lock/unlock", fStart, NUM_ITERATIONS);
+
+  fStart = GetTime();
+
+  for(int i = 0; i < NUM_THREADS; ++i)
+    threads[i] = Rtos_CreateThread(Lock, NULL);
+
+  for(int i = 0; i < NUM_THREADS; ++i)
+  {
+    Rtos_JoinThread(threads[i]);
+    Rtos_DeleteThread(threads[i]);
+  }
+
+  CHECK(s_iCounter == (long)NUM_THREADS * NUM_ITERATIONS);
+  Report("mutex, 4 threads contended", fStart, (long)NUM_THREADS * NUM_ITERATIONS);
+
+  fStart = GetTime();
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+  {
+    Rtos_ReleaseSemaphore(s_Sem);
+    Rtos_GetSemaphore(s_Sem, AL_WAIT_FOREVER);
+  }
+
+  Report("semaphore post/wait", fStart, NUM_ITERATIONS);
+
+  fStart = GetTime();
+  threads[0] = Rtos_CreateThread(Consume, NULL);
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+    Rtos_ReleaseSemaphore(s_Sem);
+
+  Rtos_JoinThread(threads[0]);
+  Rtos_DeleteThread(threads[0]);
+  Report("semaphore, 2 threads", fStart, NUM_ITERATIONS);
+
+  fStart = GetTime();
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+  {
+    Rtos_SetEvent(s_Ping);
+    Rtos_WaitEvent(s_Ping, AL_WAIT_FOREVER);
+  }
+
+  Report("event set/wait", fStart, NUM_ITERATIONS);
+
+  int iNumRounds = NUM_ITERATIONS / 10;
+  fStart = GetTime();
+  threads[0] = Rtos_CreateThread(Pong, &iNumRounds);
+
+  for(int i = 0; i < iNumRounds; ++i)
+  {
+    Rtos_SetEvent(s_Ping);
+    Rtos_WaitEvent(s_Pong, AL_WAIT_FOREVER);
+  }
+
+  Rtos_JoinThread(threads[0]);
+  Rtos_DeleteThread(threads[0]);
+  Report("event ping-pong round trip", fStart, iNumRounds);
+
+  Rtos_DeleteEvent(s_Pong);
+  Rtos_DeleteEvent(s_Ping);
+  Rtos_DeleteSemaphore(s_Sem);
+  Rtos_DeleteMutex(s_Mutex);
+
+  return EXIT_SUCCESS;
+}
+
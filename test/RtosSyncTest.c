@@ -0,0 +1,232 @@
+/******************************************************************************
+*
+* Copyright (C) 2018 Allegro DVT2.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX OR ALLEGRO DVT2 BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of  Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+*
+* Except as contained in this notice, the name of Allegro DVT2 shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Allegro DVT2.
+*
+******************************************************************************/
+
+/* Functional test of the rtos synchronization primitives: mutual exclusion
+ * under contention (with recursive locking), semaphore counting, auto-reset
+ * events and the timeouts of the timed waits. */
+
+#include "lib_rtos/lib_rtos.h"
+#include "test/Check.h"
+
+#define NUM_THREADS 4
+#define NUM_ITERATIONS 200000
+
+/* timeouts are checked with a generous upper bound: the test machine may be loaded */
+#define TIMEOUT_SLACK_MS 200
+
+static AL_MUTEX s_Mutex;
+static long s_iCounter;
+static AL_SEMAPHORE s_Sem;
+static AL_EVENT s_Ping;
+static AL_EVENT s_Pong;
+
+/*****************************************************************************/
+static void* Lock(void* pParam)
+{
+  (void)pParam;
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+  {
+    CHECK(Rtos_GetMutex(s_Mutex));
+    CHECK(Rtos_GetMutex(s_Mutex)); // rtos mutexes are recursive
+    long iCounter = s_iCounter;
+    s_iCounter = iCounter + 1;
+    CHECK(Rtos_ReleaseMutex(s_Mutex));
+    CHECK(Rtos_ReleaseMutex(s_Mutex));
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+static void* Consume(void* pParam)
+{
+  (void)pParam;
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+    CHECK(Rtos_GetSemaphore(s_Sem, AL_WAIT_FOREVER));
+
+  return NULL;
+}
+
+/*****************************************************************************/
+static void* Pong(void* pParam)
+{
+  int iNumRounds = *(int*)pParam;
+
+  for(int i = 0; i < iNumRounds; ++i)
+  {
+    CHECK(Rtos_WaitEvent(s_Ping, AL_WAIT_FOREVER));
+    CHECK(Rtos_SetEvent(s_Pong));
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+static void RunThreads(void* (*pFunc)(void*), void* pParam, int iNumThreads)
+{
+  AL_THREAD threads[NUM_THREADS];
+
+  for(int i = 0; i < iNumThreads; ++i)
+  {
+    threads[i] = Rtos_CreateThread(pFunc, pParam);
+    CHECK(threads[i]);
+  }
+
+  for(int i = 0; i < iNumThreads; ++i)
+  {
+    CHECK(Rtos_JoinThread(threads[i]));
+    Rtos_DeleteThread(threads[i]);
+  }
+}
+
+/*****************************************************************************/
+static void TestMutexContention(void)
+{
+  s_Mutex = Rtos_CreateMutex();
+  CHECK(s_Mutex);
+  s_iCounter = 0;
+
+  RunThreads(Lock, NULL, NUM_THREADS);
+
+  CHECK(s_iCounter == (long)NUM_THREADS * NUM_ITERATIONS);
+  Rtos_DeleteMutex(s_Mutex);
+}
+
+/*****************************************************************************/
+static void TestSemaphore(void)
+{
+  s_Sem = Rtos_CreateSemaphore(0);
+  CHECK(s_Sem);
+
+  AL_THREAD hConsumer = Rtos_CreateThread(Consume, NULL);
+  CHECK(hConsumer);
+
+  for(int i = 0; i < NUM_ITERATIONS; ++i)
+    CHECK(Rtos_ReleaseSemaphore(s_Sem));
+
+  CHECK(Rtos_JoinThread(hConsumer));
+  Rtos_DeleteThread(hConsumer);
+
+  /* every post was consumed exactly once */
+  CHECK(!Rtos_GetSemaphore(s_Sem, AL_NO_WAIT));
+
+  CHECK(Rtos_ReleaseSemaphore(s_Sem));
+  CHECK(Rtos_ReleaseSemaphore(s_Sem));
+  CHECK(Rtos_GetSemaphore(s_Sem, AL_NO_WAIT));
+  CHECK(Rtos_GetSemaphore(s_Sem, 10));
+  CHECK(!Rtos_GetSemaphore(s_Sem, AL_NO_WAIT));
+
+  Rtos_DeleteSemaphore(s_Sem);
+}
+
+/*****************************************************************************/
+static void TestEvent(void)
+{
+  int iNumRounds = NUM_ITERATIONS / 10;
+  s_Ping = Rtos_CreateEvent(false);
+  s_Pong = Rtos_CreateEvent(false);
+  CHECK(s_Ping && s_Pong);
+
+  /* auto-reset: several sets wake up a single wait */
+  CHECK(Rtos_SetEvent(s_Ping));
+  CHECK(Rtos_SetEvent(s_Ping));
+  CHECK(Rtos_WaitEvent(s_Ping, AL_NO_WAIT));
+  CHECK(!Rtos_WaitEvent(s_Ping, AL_NO_WAIT));
+
+  AL_THREAD hPong = Rtos_CreateThread(Pong, &iNumRounds);
+  CHECK(hPong);
+
+  for(int i = 0; i < iNumRounds; ++i)
+  {
+    CHECK(Rtos_SetEvent(s_Ping));
+    CHECK(Rtos_WaitEvent(s_Pong, AL_WAIT_FOREVER));
+  }
+
+  CHECK(Rtos_JoinThread(hPong));
+  Rtos_DeleteThread(hPong);
+
+  Rtos_DeleteEvent(s_Ping);
+  Rtos_DeleteEvent(s_Pong);
+}
+
+/*****************************************************************************/
+static void CheckTimeout(AL_64U uStart, uint32_t uTimeout)
+{
+  AL_64U uElapsed = Rtos_GetTime() - uStart;
+  printf("  %u ms timeout took %u ms\n", uTimeout, (unsigned)uElapsed);
+  CHECK(uElapsed + 1 >= uTimeout); // Rtos_GetTime has a 1 ms resolution
+  CHECK(uElapsed < uTimeout + TIMEOUT_SLACK_MS);
+}
+
+/*****************************************************************************/
+static void TestTimeouts(void)
+{
+  AL_SEMAPHORE hSem = Rtos_CreateSemaphore(0);
+  AL_EVENT hEvent = Rtos_CreateEvent(false);
+  CHECK(hSem && hEvent);
+
+  AL_64U uStart = Rtos_GetTime();
+  CHECK(!Rtos_GetSemaphore(hSem, 50));
+  CheckTimeout(uStart, 50);
+
+  uStart = Rtos_GetTime();
+  CHECK(!Rtos_WaitEvent(hEvent, 20));
+  CheckTimeout(uStart, 20);
+
+  uStart = Rtos_GetTime();
+  CHECK(!Rtos_GetSemaphore(hSem, AL_NO_WAIT));
+  CHECK(!Rtos_WaitEvent(hEvent, AL_NO_WAIT));
+  CHECK(Rtos_GetTime() - uStart < TIMEOUT_SLACK_MS);
+
+  Rtos_DeleteEvent(hEvent);
+  Rtos_DeleteSemaphore(hSem);
+}
+
+/*****************************************************************************/
+int main(void)
+{
+  TestMutexContention();
+  TestSemaphore();
+  TestEvent();
+  TestTimeouts();
+
+  printf("RtosSyncTest: OK\n");
+  return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,46 @@
+##############################################################
+# Unit tests: standalone programs, "make check" runs them all
+##############################################################
+TESTS:=
+BENCHS:=
+
+ifneq ($(ENABLE_DECODER),0)
+  TEST_LIB_A:=$(LIB_DECODER_A)
+else
+  TEST_LIB_A:=$(LIB_ENCODER_A)
+endif
+
+ifneq ($(ENABLE_DECODER),0)
+$(BIN)/test/DpbIndexTest: $(BIN)/test/DpbIndexTest.c.o $(LIB_RTOS_A)
+TESTS+=$(BIN)/test/DpbIndexTest
+
+ifeq ($(findstring linux,$(TARGET)),linux)
+$(BIN)/test/EventQueueTest: $(BIN)/test/EventQueueTest.c.o $(LIB_DECODER_A)
+TESTS+=$(BIN)/test/EventQueueTest
+
+$(BIN)/test/DecChannelMcuTest: $(BIN)/test/DecChannelMcuTest.c.o $(LIB_DECODER_A)
+TESTS+=$(BIN)/test/DecChannelMcuTest
+endif
+endif
+
+ifneq ($(ENABLE_ENCODER),0)
+$(BIN)/test/ResourceLedgerTest: $(BIN)/test/ResourceLedgerTest.c.o $(LIB_ENCODER_A)
+TESTS+=$(BIN)/test/ResourceLedgerTest
+endif
+
+$(BIN)/test/RtosSyncTest: $(BIN)/test/RtosSyncTest.c.o $(LIB_RTOS_A)
+TESTS+=$(BIN)/test/RtosSyncTest
+
+$(BIN)/test/RtosSyncBench: $(BIN)/test/RtosSyncBench.c.o $(LIB_RTOS_A)
+BENCHS+=$(BIN)/test/RtosSyncBench
+
+$(BIN)/test/HugePageBench: $(BIN)/test/HugePageBench.c.o $(TEST_LIB_A)
+BENCHS+=$(BIN)/test/HugePageBench
+
+check: $(TESTS)
+	$(Q)for test in $^; do echo "RUN $$test"; $$test || exit 1; done
+
+bench: $(BENCHS)
+	$(Q)for bench in $^; do echo "RUN $$bench"; $$bench || exit 1; done
+
+.PHONY: check bench